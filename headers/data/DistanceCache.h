@@ -0,0 +1,57 @@
+/*
+DistanceCache declaration
+
+Distances between every pair of a fixed set of Locations, worked out
+once up front. Factories don't move during a solve, so the solvers can
+look distances up by FactoryId instead of recomputing them. Above a
+memory cap the table isn't built, and distances are computed when they
+are asked for instead.
+*/
+
+#ifndef DISTANCE_CACHE_H
+#define DISTANCE_CACHE_H
+
+/////////////////
+// Includes
+/////////////////
+
+#include "Location.h"
+#include <utility>
+#include <vector>
+#include <stddef.h>
+
+/////////////////
+// DistanceCache Class
+/////////////////
+
+// Points are referred to by their index in the vector the cache was built from.
+// dist is symmetric and 0 from a point to itself, so only pairs a > b are stored.
+class DistanceCache {
+private:
+    std::vector<Location> locs_;
+    std::vector<Dist> table_; // dist(a, b) at a*(a-1)/2 + b, empty over the cap
+
+public:
+    // 64 MiB, room for a little over 4000 places
+    static const size_t DEFAULT_MAX_BYTES = size_t(64) << 20;
+
+    // O(n^2) if the table fits in max_bytes, O(n) otherwise
+    DistanceCache(const std::vector<Location>& locs = std::vector<Location>(), size_t max_bytes = DEFAULT_MAX_BYTES);
+
+    size_t size() const;
+    // true if distances are looked up, false if they are computed on the fly
+    bool isPrecomputed() const;
+    // bytes used by the table
+    size_t tableBytes() const;
+
+    // dist(locs[a], locs[b]), O(1)
+    Dist get(size_t a, size_t b) const
+    {
+        if (table_.empty()) {return dist(locs_[a], locs_[b]);}
+        if (a == b) {return Dist{0, 0};}
+        if (a < b) {std::swap(a, b);}
+        return table_[a * (a - 1) / 2 + b];
+    }
+};
+
+#endif
@@ -43,6 +43,8 @@ public:
     Factory();
     Factory(Coord x, Coord y, ResourceList netResources = ResourceList()); // Andrew Likes to use this one. 
     Factory(Location l, ResourceList rl = ResourceList());
+    // factory with some of its resources already allocated
+    Factory(Location l, ResourceList rl, ResourceList unallocated);
     // factory method
     static Factory makeJunction(Location l);
     static Factory makeJunction(Coord x, Coord y);
@@ -61,6 +63,11 @@ public:
     // deallocate is just allocation with a negated rl... right???
     bool deallocate(ResourceList rl);
 
+    // allocation on a bare base_quants/unallocated pair, so that
+    // tables of factories (see Network) can share the same rules
+    static bool allocate(const ResourceList& base_quants, ResourceList& unallocated, const ResourceList& rl);
+    static bool deallocate(const ResourceList& base_quants, ResourceList& unallocated, const ResourceList& rl);
+
     // resets Allocated resources
     // basically just sets unallocated_ to base_quants_
     void resetAllocated();
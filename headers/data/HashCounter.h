@@ -0,0 +1,194 @@
+/*
+HashCounter declaration
+
+An open addressing hash table that counts how many times each key
+was added. Keys and counts live in flat arrays, so counting millions
+of keys makes a handful of allocations instead of one per key like
+std::map does. Counts can also be taken back out, so a table can be
+kept up to date as keys come and go.
+*/
+
+#ifndef HASH_COUNTER_H
+#define HASH_COUNTER_H
+
+/////////////////
+// Includes
+/////////////////
+
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+#include <utility>
+#include <stddef.h>
+#include <stdint.h>
+
+/////////////////
+// HashCounter Class
+/////////////////
+
+// Key must be default constructible and comparable with ==.
+// Hash is applied to a key and then mixed, so a hash that is
+// only unique (like LocationHasher) is good enough.
+template <typename Key, typename Hash>
+class HashCounter {
+private:
+    std::vector<Key> keys_;
+    std::vector<uint32_t> counts_; // 0 marks an empty slot
+    size_t size_;
+    size_t mask_;                  // capacity - 1, capacity is a power of 2
+
+    size_t slot(const Key& key) const
+    {
+        return (uint64_t(Hash()(key)) * 0x9E3779B97F4A7C15ull >> 32) & mask_;
+    }
+
+    // empties slot s, moving later keys of its probe run back
+    // so every key stays reachable from its home slot
+    void erase(size_t s)
+    {
+        counts_[s] = 0;
+        size_--;
+        size_t hole = s;
+        for (size_t i = (s + 1) & mask_; counts_[i] != 0; i = (i + 1) & mask_)
+        {
+            // the key at i can fill the hole if the hole is between its home and i
+            if (((i - slot(keys_[i])) & mask_) >= ((i - hole) & mask_))
+            {
+                keys_[hole] = keys_[i];
+                counts_[hole] = counts_[i];
+                counts_[i] = 0;
+                hole = i;
+            }
+        }
+    }
+
+    void grow()
+    {
+        std::vector<Key> old_keys;
+        std::vector<uint32_t> old_counts;
+        old_keys.swap(keys_);
+        old_counts.swap(counts_);
+        keys_.assign(old_keys.size() * 2, Key());
+        counts_.assign(old_counts.size() * 2, 0);
+        mask_ = keys_.size() - 1;
+        for (size_t i = 0; i < old_keys.size(); i++)
+        {
+            if (old_counts[i] == 0) {continue;}
+            size_t s = slot(old_keys[i]);
+            while (counts_[s] != 0) {s = (s + 1) & mask_;}
+            keys_[s] = old_keys[i];
+            counts_[s] = old_counts[i];
+        }
+    }
+
+public:
+    // expected is the number of distinct keys to make room for up front
+    explicit HashCounter(size_t expected = 0) :
+        size_(0)
+    {
+        size_t capacity = 16;
+        while (capacity < expected * 2) {capacity *= 2;}
+        keys_.assign(capacity, Key());
+        counts_.assign(capacity, 0);
+        mask_ = capacity - 1;
+    }
+
+    // O(1) average
+    void increment(const Key& key)
+    {
+        add(key, 1);
+    }
+
+    // adds n > 0 to the count of key, O(1) average
+    void add(const Key& key, uint32_t n)
+    {
+        size_t s = slot(key);
+        while (counts_[s] != 0)
+        {
+            if (keys_[s] == key)
+            {
+                counts_[s] += n;
+                return;
+            }
+            s = (s + 1) & mask_;
+        }
+        keys_[s] = key;
+        counts_[s] = n;
+        // stay at most half full so probes stay short
+        if (++size_ * 2 > keys_.size()) {grow();}
+    }
+
+    // takes n > 0 from the count of key, forgetting key once it reaches 0
+    // O(1) average
+    //   if key's count is below n, throw out_of_range
+    void subtract(const Key& key, uint32_t n)
+    {
+        for (size_t s = slot(key); counts_[s] != 0; s = (s + 1) & mask_)
+        {
+            if (!(keys_[s] == key)) {continue;}
+            if (counts_[s] < n) {break;}
+            counts_[s] -= n;
+            if (counts_[s] == 0) {erase(s);}
+            return;
+        }
+        throw std::out_of_range("HashCounter count would go below 0");
+    }
+
+    // O(1) average, 0 if key was never added
+    uint32_t count(const Key& key) const
+    {
+        for (size_t s = slot(key); counts_[s] != 0; s = (s + 1) & mask_)
+        {
+            if (keys_[s] == key) {return counts_[s];}
+        }
+        return 0;
+    }
+
+    // forgets every key but keeps the capacity, so counting
+    // again doesn't allocate, O(capacity)
+    void clear()
+    {
+        std::fill(counts_.begin(), counts_.end(), 0);
+        size_ = 0;
+    }
+
+    // number of distinct keys
+    size_t size() const
+    {
+        return size_;
+    }
+
+    // same keys with the same counts, whatever the capacities
+    // O(capacity)
+    bool operator==(const HashCounter& other) const
+    {
+        if (size_ != other.size_) {return false;}
+        for (size_t i = 0; i < keys_.size(); i++)
+        {
+            if (counts_[i] != 0 && other.count(keys_[i]) != counts_[i]) {return false;}
+        }
+        return true;
+    }
+    bool operator!=(const HashCounter& other) const
+    {
+        return !operator==(other);
+    }
+
+    // adds every count of other to this one, O(other capacity)
+    void merge(const HashCounter& other)
+    {
+        other.forEach([this](const Key& key, uint32_t n) { add(key, n); });
+    }
+
+    // calls visit(key, count) for every key, in no particular order
+    template <typename Visit>
+    void forEach(Visit visit) const
+    {
+        for (size_t i = 0; i < keys_.size(); i++)
+        {
+            if (counts_[i] != 0) {visit(keys_[i], counts_[i]);}
+        }
+    }
+};
+
+#endif
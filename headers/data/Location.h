@@ -39,9 +39,13 @@ struct Dist {
     Dist operator+=(const Dist& other);
 
     double toDouble() const; 
+
+    // -1, 0 or 1 as this is shorter, equal or longer than other
+    // exact, compared in integers rather than through toDouble
+    int compare(const Dist& other) const;
     
     // comparison operators
-    // returns based on the actual length of the distance
+    // returns based on the actual length of the distance, exactly
     bool operator==(const Dist& other) const;
     bool operator>(const Dist& other) const;
     bool operator<(const Dist& other) const;
@@ -17,7 +17,11 @@ It is the highest level of data structure used in this project.
 
 #include "../data/Route.h"
 #include "../data/Factory.h"
+#include "../data/DistanceCache.h"
 #include <vector>
+#include <iterator>
+#include <memory>
+#include <mutex>
 #include <unordered_map>
 
 /////////////////
@@ -25,24 +29,168 @@ It is the highest level of data structure used in this project.
 /////////////////
 
 typedef uint32_t RouteKey;
+// index of a place in a Network's factory table
+// ids are stable until a place is erased from the network
+typedef uint32_t FactoryId;
 
 /////////////////
 // Network Class
 /////////////////
 
 class Network {
+public:
+    static const FactoryId NO_FACTORY = 0xffffffff;
+
+    // iterates over places in Location order
+    // dereferences to a std::pair<FactoryKey, Factory> built from the factory table,
+    // so it->first is the key of the place and it->second is the place itself.
+    class FactoryIterator {
+    public:
+        typedef std::random_access_iterator_tag iterator_category;
+        typedef std::pair<FactoryKey, Factory> value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef value_type reference;
+        // lets it->first work on the temporary pair
+        struct pointer {
+            value_type pair;
+            const value_type* operator->() const { return &pair; }
+        };
+
+        FactoryIterator(const Network* net, size_t pos) : net_(net), pos_(pos) {}
+
+        reference operator*() const;
+        pointer operator->() const { return pointer{operator*()}; }
+        FactoryId id() const; // id of the current place
+
+        FactoryIterator& operator++() { pos_++; return *this; }
+        FactoryIterator operator++(int) { FactoryIterator orig = *this; pos_++; return orig; }
+        FactoryIterator& operator--() { pos_--; return *this; }
+        FactoryIterator operator--(int) { FactoryIterator orig = *this; pos_--; return orig; }
+        FactoryIterator& operator+=(difference_type n) { pos_ += n; return *this; }
+        FactoryIterator& operator-=(difference_type n) { pos_ -= n; return *this; }
+        FactoryIterator operator+(difference_type n) const { return FactoryIterator(net_, pos_ + n); }
+        FactoryIterator operator-(difference_type n) const { return FactoryIterator(net_, pos_ - n); }
+        difference_type operator-(const FactoryIterator& other) const { return pos_ - other.pos_; }
+        reference operator[](difference_type n) const { return *(*this + n); }
+
+        bool operator==(const FactoryIterator& other) const { return pos_ == other.pos_ && net_ == other.net_; }
+        bool operator!=(const FactoryIterator& other) const { return !operator==(other); }
+        bool operator<(const FactoryIterator& other) const { return pos_ < other.pos_; }
+        bool operator>(const FactoryIterator& other) const { return pos_ > other.pos_; }
+        bool operator<=(const FactoryIterator& other) const { return pos_ <= other.pos_; }
+        bool operator>=(const FactoryIterator& other) const { return pos_ >= other.pos_; }
+
+    private:
+        const Network* net_;
+        size_t pos_; // position in the network's Location ordering
+    };
+
+    // iterates over routes in RouteKey order, dereferences to const Route&
+    class RouteIterator {
+    public:
+        typedef std::random_access_iterator_tag iterator_category;
+        typedef Route value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const Route& reference;
+        typedef const Route* pointer;
+
+        RouteIterator(std::vector<std::shared_ptr<Route>>::const_iterator it) : it_(it) {}
+
+        reference operator*() const { return **it_; }
+        pointer operator->() const { return it_->get(); }
+
+        RouteIterator& operator++() { ++it_; return *this; }
+        RouteIterator operator++(int) { RouteIterator orig = *this; ++it_; return orig; }
+        RouteIterator& operator--() { --it_; return *this; }
+        RouteIterator operator--(int) { RouteIterator orig = *this; --it_; return orig; }
+        RouteIterator& operator+=(difference_type n) { it_ += n; return *this; }
+        RouteIterator& operator-=(difference_type n) { it_ -= n; return *this; }
+        RouteIterator operator+(difference_type n) const { return RouteIterator(it_ + n); }
+        RouteIterator operator-(difference_type n) const { return RouteIterator(it_ - n); }
+        difference_type operator-(const RouteIterator& other) const { return it_ - other.it_; }
+        reference operator[](difference_type n) const { return *it_[n]; }
+
+        bool operator==(const RouteIterator& other) const { return it_ == other.it_; }
+        bool operator!=(const RouteIterator& other) const { return it_ != other.it_; }
+        bool operator<(const RouteIterator& other) const { return it_ < other.it_; }
+        bool operator>(const RouteIterator& other) const { return it_ > other.it_; }
+        bool operator<=(const RouteIterator& other) const { return it_ <= other.it_; }
+        bool operator>=(const RouteIterator& other) const { return it_ >= other.it_; }
+
+    private:
+        std::vector<std::shared_ptr<Route>>::const_iterator it_;
+    };
+
 private:
-    // places_ stores factories and junctions.
-    // Factories are distinguished by producing or consuming something,
-    // whereas junctions do not produce or consume anything.
-    std::map<FactoryKey, Factory, LocationCompare> places_;
-    std::vector<Route> routes_;      // stores route objects
+    // distances between the places of a factory table, built the first
+    // time one is asked for
+    struct DistanceSlot {
+        std::once_flag built;
+        DistanceCache cache;
+    };
+    // ids of a factory table sorted by Location, keeps iteration order
+    // deterministic. Built the first time the places are iterated, so adding
+    // places one at a time sorts once instead of shifting the order every time
+    struct OrderSlot {
+        std::once_flag sorted;
+        std::vector<FactoryId> ids;
+    };
+
+    // The factory table stores factories and junctions as a struct of arrays
+    // indexed by FactoryId. Factories are distinguished by producing or 
+    // consuming something, whereas junctions do not produce or consume anything.
+    struct FactoryTable {
+        std::vector<Location> locs;
+        std::vector<ResourceList> base_quants;
+        // open addressing index from Location to FactoryId, size is a power of 2
+        std::vector<FactoryId> index;
+        size_t num_junctions = 0;
+        // shared by every network using the table, replaced when places change
+        std::shared_ptr<OrderSlot> order = std::make_shared<OrderSlot>();
+        std::shared_ptr<DistanceSlot> distances = std::make_shared<DistanceSlot>();
+    };
+
+    // Copies of a network share their data, and only copy the parts they change
+    // (copy on write). The factory table only changes when places are added or
+    // erased, allocations change when routes are edited, and a route is only 
+    // copied when that route is edited. This keeps solver populations of many 
+    // similar networks close to the size of one network.
+    std::shared_ptr<FactoryTable> table_;
+    std::shared_ptr<std::vector<ResourceList>> unallocated_; // indexed by FactoryId
+    std::vector<std::shared_ptr<Route>> routes_;      // stores route objects
+
+    // running tallies for Constraints::quickCheck
+    size_t num_deficits_;               // (place, resource) pairs with a negative unallocated quant
+    std::vector<uint32_t> route_twice_; // stops followed by the same stop, per route
+    size_t num_twice_;                  // sum of route_twice_
+
+    // copy on write helpers, return data that only this network owns
+    FactoryTable& editTable();
+    std::vector<ResourceList>& editUnallocated();
+    Route& editRoute(RouteKey key); // throws std::out_of_range if key is not a route
+
+    // factory table helpers
+    FactoryId findId(FactoryKey key) const; // NO_FACTORY if key is not in the table
+    FactoryId atId(FactoryKey key) const;   // throws std::out_of_range if key is not in the table
+    static void rebuildIndex(FactoryTable& table, size_t capacity);
+    // ids in Location order, O(f log f) the first time for a table, O(1) after
+    const std::vector<FactoryId>& placeOrder() const;
+    bool allocate(FactoryKey key, const ResourceList& rl);
+    bool deallocate(FactoryKey key, const ResourceList& rl);
+    bool allocateId(FactoryId id, const ResourceList& rl);
+    bool deallocateId(FactoryId id, const ResourceList& rl);
+    void retallyRoute(RouteKey key); // recounts route_twice_ after the stops of a route change
 
 public:
 
     // constructor
     Network();
     Network(std::vector<Factory> facts);
+    // builds every place at once from n locations and their base quants,
+    // O(f) if locs is already in Location order, O(f log f) otherwise.
+    // Much faster than adding the places one at a time.
+    //   if a location appears twice, throw invalid_argument
+    Network(const Location* locs, const ResourceList* base_quants, size_t n);
 
     // getters for size
     const size_t getNumFactories() const;  // returns number of factories
@@ -50,16 +198,30 @@ public:
     const size_t getNumRoutes() const;     // returns number of routes
 
     // getters for container iterators
-    std::map<FactoryKey, Factory, LocationCompare>::const_iterator factCBegin() const; // use to iterate over Location, Factory pairs
-    std::map<FactoryKey, Factory, LocationCompare>::const_iterator factCEnd() const;
-    std::vector<Route>::const_iterator routeCBegin() const; // use to iterate over routes.
-    std::vector<Route>::const_iterator routeCEnd() const;
+    FactoryIterator factCBegin() const; // use to iterate over Location, Factory pairs
+    FactoryIterator factCEnd() const;
+    RouteIterator routeCBegin() const; // use to iterate over routes.
+    RouteIterator routeCEnd() const;
 
     // getters for elements
-    const Factory& getPlace(FactoryKey key) const; // returns factory at given index
+    Factory getPlace(FactoryKey key) const; // returns factory at given index, throws std::out_of_range if missing
     const Route& getRoute(RouteKey index) const; // returns Route at given index
     bool hasPlace(FactoryKey key) const;
 
+    // getters for the factory table, these avoid building a Factory
+    // and are what the solvers should use in hot loops
+    FactoryId getPlaceId(FactoryKey key) const; // NO_FACTORY if key is not in the network
+    const std::vector<FactoryId>& getPlaceIds() const; // all ids in Location order
+    const Location& getPlaceLoc(FactoryId id) const;
+    const ResourceList& getPlaceBaseQuants(FactoryId id) const;
+    const ResourceList& getPlaceUnallocated(FactoryId id) const;
+    // distance between two places, looked up in getDistances(), O(1)
+    Dist getPlaceDist(FactoryId a, FactoryId b) const;
+    // distances between every pair of places, indexed by FactoryId.
+    // Built on first use and shared by copies of the network until places
+    // are added or erased. Safe to call from several threads at once.
+    const DistanceCache& getDistances() const;
+
 
     // erase the place at the given key, no matter what it is.
     // will also remove key from all routes that it is a part of,
@@ -118,6 +280,12 @@ public:
     void eraseAllRoutes();
 
 
+    // number of (place, resource) pairs where more is consumed than supplied, O(1)
+    size_t getNumDeficits() const;
+    // number of times a route visits the same place twice in a row, 
+    // counting the last stop followed by the first, O(1)
+    size_t getNumTwiceViolations() const;
+
     // return a list of factory indecies with a deficit of the given resource
     // if no resource is given then will give all factories with any deficit
     std::vector<FactoryKey> getDeficit(Resource resource = Resource::COUNT) const;
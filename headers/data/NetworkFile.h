@@ -0,0 +1,120 @@
+/*
+NetworkFile declaration
+
+A compact binary file format for Networks, so layouts can be saved and
+loaded instead of being rebuilt in code every run. The file holds the
+places (Location and base quants) and the routes (stop keys and
+commands) as flat arrays, laid out exactly like they are in memory.
+Reading one maps the file and points straight into it, so the factory
+table is available without copying or parsing anything.
+
+Layout, all little endian:
+    NetworkFileHeader
+    Location     place_locs[num_places]       in Location order
+    ResourceList place_quants[num_places]     base quants, all 0 for junctions
+    uint64_t     route_starts[num_routes + 1] stops of route r are [route_starts[r], route_starts[r+1])
+    Location     stop_keys[num_stops]
+    ResourceList stop_commands[num_stops]
+Every array starts on a multiple of NetworkFile::ALIGNMENT bytes.
+*/
+
+#ifndef NETWORK_FILE_H
+#define NETWORK_FILE_H
+
+/////////////////
+// Includes
+/////////////////
+
+#include "Network.h"
+#include <string>
+#include <vector>
+#include <stddef.h>
+#include <stdint.h>
+
+/////////////////
+// File Format
+/////////////////
+
+namespace NetworkFile {
+    const char MAGIC[8] = {'F', 'A', 'C', 'T', 'N', 'E', 'T', '\0'};
+    // bumped whenever the layout changes, older versions are rejected
+    const uint32_t VERSION = 1;
+    const uint64_t ALIGNMENT = 64;
+}
+
+// offsets are in bytes from the start of the file
+struct NetworkFileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t num_resources; // must match Resource::COUNT
+    uint64_t num_places;
+    uint64_t num_routes;
+    uint64_t num_stops;
+    uint64_t place_locs_offset;
+    uint64_t place_quants_offset;
+    uint64_t route_starts_offset;
+    uint64_t stop_keys_offset;
+    uint64_t stop_commands_offset;
+    uint64_t file_size;
+};
+
+/////////////////
+// Writing
+/////////////////
+
+// writes every place and route of net to path, replacing the file.
+// Unallocated quants aren't stored, loading adds the routes again.
+//   if the file can't be written, throw runtime_error
+void writeNetworkFile(const Network& net, const std::string& path);
+
+/////////////////
+// MappedNetworkFile Class
+/////////////////
+
+// A network file mapped into memory. The pointers it hands out point
+// into the mapping, and are valid until it is destroyed.
+class MappedNetworkFile {
+private:
+    const char* data_;
+    size_t size_;
+    bool mapped_;             // data_ is a mapping, otherwise it points into buffer_
+    std::vector<char> buffer_; // the file contents where it can't be mapped
+    const NetworkFileHeader* header_;
+    const uint64_t* route_starts_;
+
+    // throws invalid_argument if the contents aren't a network file this can read
+    void validate();
+    void release();
+
+public:
+    // O(routes)
+    //   if the file can't be opened or read, throw runtime_error
+    //   if it isn't a valid network file, throw invalid_argument
+    explicit MappedNetworkFile(const std::string& path);
+    ~MappedNetworkFile();
+    MappedNetworkFile(const MappedNetworkFile& other) = delete;
+    MappedNetworkFile& operator=(const MappedNetworkFile& other) = delete;
+
+    // places, indexed the same in both arrays and in Location order
+    size_t getNumPlaces() const;
+    const Location* getPlaceLocs() const;
+    const ResourceList* getPlaceBaseQuants() const;
+
+    // routes, each stop's key and command are indexed the same
+    //   if route isn't in the file, throw out_of_range
+    size_t getNumRoutes() const;
+    size_t getRouteSize(RouteKey route) const;
+    const Location* getRouteStops(RouteKey route) const;
+    const ResourceList* getRouteCommands(RouteKey route) const;
+
+    // a Network with the places and routes of the file, O(f + s)
+    //   if a route can't be added to the places, throw invalid_argument
+    Network toNetwork() const;
+};
+
+// MappedNetworkFile(path).toNetwork()
+Network readNetworkFile(const std::string& path);
+// true if the file at path starts like a network file, only reads the magic
+bool isNetworkFile(const std::string& path);
+
+#endif
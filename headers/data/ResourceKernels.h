@@ -0,0 +1,211 @@
+/*
+ResourceKernels definitions
+
+Lane wise kernels over arrays of Quants, used by ResourceList and
+Factory for the arithmetic, comparisons and allocation checks that run
+millions of times per solve. Each kernel works four lanes at a time
+with SSE2 where it is available, and falls back to plain loops
+elsewhere. Both give the same results.
+*/
+
+#ifndef RESOURCE_KERNELS_H
+#define RESOURCE_KERNELS_H
+
+/////////////////
+// Includes
+/////////////////
+
+#include <stddef.h>
+#include <stdint.h>
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define RESOURCE_KERNELS_SSE2
+#endif
+
+/////////////////
+// Kernels
+/////////////////
+
+// lanes are int32s, in blocks of 4 with a scalar tail for any remainder
+namespace ResourceKernels {
+
+#ifdef RESOURCE_KERNELS_SSE2
+    inline __m128i load(const int32_t* p) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); }
+    inline void store(int32_t* p, __m128i v) { _mm_storeu_si128(reinterpret_cast<__m128i*>(p), v); }
+    // one bit per lane that is all ones in v
+    inline uint32_t laneBits(__m128i v) { return _mm_movemask_ps(_mm_castsi128_ps(v)); }
+    // |v|, SSE2 has no abs for int32
+    inline __m128i absLanes(__m128i v)
+    {
+        __m128i sign = _mm_srai_epi32(v, 31);
+        return _mm_sub_epi32(_mm_xor_si128(v, sign), sign);
+    }
+    // lanes where the sign of rl is neither 0 nor the sign of base
+    inline __m128i badSign(__m128i base, __m128i rl)
+    {
+        const __m128i zero = _mm_setzero_si128();
+        __m128i bad_pos = _mm_andnot_si128(_mm_cmpgt_epi32(base, zero), _mm_cmpgt_epi32(rl, zero));
+        __m128i bad_neg = _mm_andnot_si128(_mm_cmplt_epi32(base, zero), _mm_cmplt_epi32(rl, zero));
+        return _mm_or_si128(bad_pos, bad_neg);
+    }
+#endif
+
+    // lanes before this are done four at a time, the rest one at a time.
+    // The tail loops start from this constant rather than where the block loop
+    // stopped, so the compiler sees a tail that is empty when N is a multiple of 4
+    template <size_t N>
+    constexpr size_t blockEnd()
+    {
+#ifdef RESOURCE_KERNELS_SSE2
+        return N - N % 4;
+#else
+        return 0;
+#endif
+    }
+
+    inline int32_t absScalar(int32_t v) { return v < 0 ? -v : v; }
+    inline bool badSignScalar(int32_t base, int32_t rl)
+    {
+        return (rl > 0 && !(base > 0)) | (rl < 0 && !(base < 0));
+    }
+
+    // out = a + b
+    template <size_t N>
+    inline void add(const int32_t* a, const int32_t* b, int32_t* out)
+    {
+#ifdef RESOURCE_KERNELS_SSE2
+        for (size_t i = 0; i < blockEnd<N>(); i += 4) {store(out + i, _mm_add_epi32(load(a + i), load(b + i)));}
+#endif
+        for (size_t i = blockEnd<N>(); i < N; i++) {out[i] = a[i] + b[i];}
+    }
+
+    // out = a - b
+    template <size_t N>
+    inline void sub(const int32_t* a, const int32_t* b, int32_t* out)
+    {
+#ifdef RESOURCE_KERNELS_SSE2
+        for (size_t i = 0; i < blockEnd<N>(); i += 4) {store(out + i, _mm_sub_epi32(load(a + i), load(b + i)));}
+#endif
+        for (size_t i = blockEnd<N>(); i < N; i++) {out[i] = a[i] - b[i];}
+    }
+
+    // a == b in every lane
+    template <size_t N>
+    inline bool equal(const int32_t* a, const int32_t* b)
+    {
+        uint32_t diff = 0;
+#ifdef RESOURCE_KERNELS_SSE2
+        for (size_t i = 0; i < blockEnd<N>(); i += 4) {diff |= laneBits(_mm_cmpeq_epi32(load(a + i), load(b + i))) ^ 0xF;}
+#endif
+        for (size_t i = blockEnd<N>(); i < N; i++) {diff |= a[i] != b[i];}
+        return diff == 0;
+    }
+
+    // bit i is set if lane i is < 0
+    template <size_t N>
+    inline uint64_t negativeMask(const int32_t* a)
+    {
+        static_assert(N <= 64, "a mask holds at most 64 lanes");
+        uint64_t mask = 0;
+#ifdef RESOURCE_KERNELS_SSE2
+        for (size_t i = 0; i < blockEnd<N>(); i += 4) {mask |= uint64_t(laneBits(_mm_cmplt_epi32(load(a + i), _mm_setzero_si128()))) << i;}
+#endif
+        for (size_t i = blockEnd<N>(); i < N; i++) {mask |= uint64_t(a[i] < 0) << i;}
+        return mask;
+    }
+
+    // bit i is set if lane i is > 0
+    template <size_t N>
+    inline uint64_t positiveMask(const int32_t* a)
+    {
+        static_assert(N <= 64, "a mask holds at most 64 lanes");
+        uint64_t mask = 0;
+#ifdef RESOURCE_KERNELS_SSE2
+        for (size_t i = 0; i < blockEnd<N>(); i += 4) {mask |= uint64_t(laneBits(_mm_cmpgt_epi32(load(a + i), _mm_setzero_si128()))) << i;}
+#endif
+        for (size_t i = blockEnd<N>(); i < N; i++) {mask |= uint64_t(a[i] > 0) << i;}
+        return mask;
+    }
+
+    // sum of every lane
+    template <size_t N>
+    inline int32_t sum(const int32_t* a)
+    {
+        int32_t total = 0;
+#ifdef RESOURCE_KERNELS_SSE2
+        __m128i acc = _mm_setzero_si128();
+        for (size_t i = 0; i < blockEnd<N>(); i += 4) {acc = _mm_add_epi32(acc, load(a + i));}
+        int32_t lanes[4];
+        store(lanes, acc);
+        total = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+#endif
+        for (size_t i = blockEnd<N>(); i < N; i++) {total += a[i];}
+        return total;
+    }
+
+    // sets every negative lane to 0
+    template <size_t N>
+    inline void clampNegative(int32_t* a)
+    {
+#ifdef RESOURCE_KERNELS_SSE2
+        for (size_t i = 0; i < blockEnd<N>(); i += 4)
+        {
+            __m128i v = load(a + i);
+            store(a + i, _mm_andnot_si128(_mm_srai_epi32(v, 31), v));
+        }
+#endif
+        for (size_t i = blockEnd<N>(); i < N; i++) {a[i] = a[i] < 0 ? 0 : a[i];}
+    }
+
+    // Factory::allocate on raw lanes. Every lane is checked before any is
+    // written, so a failed allocation leaves unallocated untouched.
+    // a lane can be allocated if rl is 0 or has the sign of base,
+    // and |unallocated| >= |rl|
+    template <size_t N>
+    inline bool allocate(const int32_t* base, int32_t* unallocated, const int32_t* rl)
+    {
+        uint32_t bad = 0; // any bit set means some lane fails
+#ifdef RESOURCE_KERNELS_SSE2
+        for (size_t i = 0; i < blockEnd<N>(); i += 4)
+        {
+            __m128i r = load(rl + i);
+            __m128i short_of = _mm_cmpgt_epi32(absLanes(r), absLanes(load(unallocated + i)));
+            bad |= laneBits(_mm_or_si128(badSign(load(base + i), r), short_of));
+        }
+#endif
+        for (size_t i = blockEnd<N>(); i < N; i++)
+        {
+            bad |= badSignScalar(base[i], rl[i]) | (absScalar(rl[i]) > absScalar(unallocated[i]));
+        }
+        if (bad) {return false;}
+        sub<N>(unallocated, rl, unallocated);
+        return true;
+    }
+
+    // Factory::deallocate on raw lanes, checked like allocate.
+    // a lane can be deallocated if rl is 0 or has the sign of base,
+    // and |base - unallocated| >= |rl|
+    template <size_t N>
+    inline bool deallocate(const int32_t* base, int32_t* unallocated, const int32_t* rl)
+    {
+        uint32_t bad = 0; // any bit set means some lane fails
+#ifdef RESOURCE_KERNELS_SSE2
+        for (size_t i = 0; i < blockEnd<N>(); i += 4)
+        {
+            __m128i b = load(base + i), r = load(rl + i);
+            __m128i allocated = _mm_sub_epi32(b, load(unallocated + i));
+            __m128i short_of = _mm_cmpgt_epi32(absLanes(r), absLanes(allocated));
+            bad |= laneBits(_mm_or_si128(badSign(b, r), short_of));
+        }
+#endif
+        for (size_t i = blockEnd<N>(); i < N; i++)
+        {
+            bad |= badSignScalar(base[i], rl[i]) | (absScalar(rl[i]) > absScalar(base[i] - unallocated[i]));
+        }
+        if (bad) {return false;}
+        add<N>(unallocated, rl, unallocated);
+        return true;
+    }
+}
+
+#endif
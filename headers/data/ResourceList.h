@@ -18,6 +18,25 @@ Uses overloaded functions for ++ and --
 #include <vector>
 #include <list>
 #include <map>
+#include <string_view>
+#include <stddef.h>
+#include <stdint.h>
+
+/////////////////
+// Compile Commands
+/////////////////
+
+// number of resources in the catalogue, from 3 to 64. Every ResourceList is
+// exactly this wide, so define it for the whole build to fit the factories
+// being planned: -DRESOURCE_COUNT=3 for a copper, steel and iron outpost
+// walks 3 lanes instead of 12, -DRESOURCE_COUNT=60 models modded factories.
+// The catalogue starts with the named Factorio items of the Resource enum,
+// as many as fit, and resources past them are called Resource12, Resource13
+// and so on. Network and solution files only load in a build with the
+// catalogue they were written in.
+#ifndef RESOURCE_COUNT
+#define RESOURCE_COUNT 12
+#endif
 
 /////////////////
 // Custom sign tracker per: https://stackoverflow.com/a/4609795
@@ -38,7 +57,13 @@ Sign signof(T n) {
 // to create a resource from an integer use:
 // Resource a = Resource(0)
 // for example
-enum Resource { Copper, Steel, Iron, Stone, Uranium, Circuits, Fish, Wood, NuclearFuel, Wire, Engine, Gear, COUNT };
+// COUNT is the size of the catalogue. Resources from NUM_NAMED_RESOURCES up to it
+// have no enumerator, and named resources from COUNT up aren't in the catalogue.
+enum Resource : int { Copper, Steel, Iron, Stone, Uranium, Circuits, Fish, Wood, NuclearFuel, Wire, Engine, Gear,
+    NUM_NAMED_RESOURCES, COUNT = RESOURCE_COUNT };
+// sign masks hold one bit per resource, and the canonical examples move
+// copper, steel and iron
+static_assert(Resource::COUNT >= 3 && Resource::COUNT <= 64, "RESOURCE_COUNT must be between 3 and 64");
 
 // not prefered, use ResourceList::iterator to iterate through a list of resources if possible
 
@@ -49,6 +74,18 @@ Resource operator++(Resource& r, int);
 Resource& operator--(Resource& r);
 Resource operator--(Resource& r, int);
 
+// name of a resource as it is spelled in the enum, like "NuclearFuel",
+// or "Resource<r>" past the named resources
+//   if r isn't in the catalogue, throw out_of_range
+const char* resourceName(Resource r);
+// finds the resource called name, ignoring case and any '_', '-' or ' ',
+// so "NuclearFuel", "nuclear_fuel" and "nuclear-fuel" all match
+//   returns false if no resource has that name
+bool parseResource(std::string_view name, Resource& r);
+// a == b ignoring case and any '_', '-' or ' ', how every name given on
+// the command line or in an import is matched
+bool sameName(std::string_view a, std::string_view b);
+
 // type used for a number of resources. negative Quant represents a resource demand.
 typedef int32_t Quant;
 
@@ -56,18 +93,24 @@ typedef int32_t Quant;
 // neg Quant = demand
 // pos Quant = produce
 
-// ResourceList class
-// this stores a list of resources that can be accessed with [] and 
+// BasicResourceList class
+// this stores a list of N resources that can be accessed with [] and 
 // provides information about what resources it contains.
-class ResourceList : public std::array<Quant, Resource::COUNT> {
+// Only N = Resource::COUNT is instantiated (in ResourceList.cpp), see
+// RESOURCE_COUNT to change it.
+template <size_t N>
+class BasicResourceList : public std::array<Quant, N> {
 private:
 
 public:
+    static const size_t NUM_RESOURCES = N;
 
     // default constructor assigns all Quants to 0
-    ResourceList();
+    BasicResourceList();
     // assign resource list from a map, which can be created with an initializer_list
-    ResourceList(std::map<Resource, Quant> rs);
+    //   resources missing from the map are 0
+    //   if a resource isn't in the list, throw out_of_range
+    BasicResourceList(std::map<Resource, Quant> rs);
 
     // is the list empty?
     // returns whether all quatities are 0
@@ -77,26 +120,40 @@ public:
     // checks that all values in the list are positive
     bool allPositive() const;
 
+    // bit r is set if resource r is negative or positive in this list
+    uint64_t negativeMask() const;
+    uint64_t positiveMask() const;
+
+    // sum of all Quants
+    Quant total() const;
+    // sets every negative Quant to 0
+    void clampNegative();
+
     // get list of which resources are positive or negative in this list
     std::list<Resource> getNegative() const;
     std::list<Resource> getPositive() const;
     // get a RL of the resources are that are positive or negative in this list
     //   all other Quants set to 0
-    ResourceList getNegativeList() const;
-    ResourceList getPositiveList() const;
+    BasicResourceList getNegativeList() const;
+    BasicResourceList getPositiveList() const;
 
     // adds or subtracts two lists element wise
-    ResourceList operator+(const ResourceList& rl) const;
-    ResourceList operator-(const ResourceList& rl) const;
+    BasicResourceList operator+(const BasicResourceList& rl) const;
+    BasicResourceList operator-(const BasicResourceList& rl) const;
 
-    ResourceList& operator+=(const ResourceList& rl);
-    ResourceList& operator-=(const ResourceList& rl);
+    BasicResourceList& operator+=(const BasicResourceList& rl);
+    BasicResourceList& operator-=(const BasicResourceList& rl);
 
     // define == element wise; Two Resourcelists are
     // equal if each resource has the same quantity 
     // in each list.
-    bool operator==(const ResourceList& other) const;
+    bool operator==(const BasicResourceList& other) const;
 
 };
 
+// the list of every Resource in the catalogue, used everywhere else
+typedef BasicResourceList<Resource::COUNT> ResourceList;
+
+extern template class BasicResourceList<Resource::COUNT>;
+
 #endif
\ No newline at end of file
@@ -19,6 +19,9 @@ taken across a route
 #include "ResourceList.h"
 #include "Location.h"
 #include "PairList.h"
+#include "SmallVector.h"
+#include <iterator>
+#include <atomic>
 #include <map>
 
 /////////////////
@@ -38,8 +41,77 @@ typedef Location FactoryKey;
 // resourceLists in factories.
 // The ResourceList at each stop can be interpreted as the "command" of the route at that stop. 
 class Route {
+public:
+    // routes with up to this many stops don't allocate
+    static const size_t INLINE_STOPS = 4;
+
+    // iterates over stops in order
+    // dereferences to a std::pair<const FactoryKey&, const ResourceList&> into the route,
+    // so it->first is the key of the stop's factory and it->second is its command.
+    class const_iterator {
+    public:
+        typedef std::random_access_iterator_tag iterator_category;
+        typedef std::pair<FactoryKey, ResourceList> value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef std::pair<const FactoryKey&, const ResourceList&> reference;
+        // lets it->first work on the temporary pair
+        struct pointer {
+            reference pair;
+            const reference* operator->() const { return &pair; }
+        };
+
+        const_iterator(const FactoryKey* keys, const ResourceList* commands, size_t pos) : keys_(keys), commands_(commands), pos_(pos) {}
+
+        reference operator*() const { return reference(keys_[pos_], commands_[pos_]); }
+        pointer operator->() const { return pointer{operator*()}; }
+
+        const_iterator& operator++() { pos_++; return *this; }
+        const_iterator operator++(int) { const_iterator orig = *this; pos_++; return orig; }
+        const_iterator& operator--() { pos_--; return *this; }
+        const_iterator operator--(int) { const_iterator orig = *this; pos_--; return orig; }
+        const_iterator& operator+=(difference_type n) { pos_ += n; return *this; }
+        const_iterator& operator-=(difference_type n) { pos_ -= n; return *this; }
+        const_iterator operator+(difference_type n) const { return const_iterator(keys_, commands_, pos_ + n); }
+        const_iterator operator-(difference_type n) const { return const_iterator(keys_, commands_, pos_ - n); }
+        difference_type operator-(const const_iterator& other) const { return pos_ - other.pos_; }
+        reference operator[](difference_type n) const { return *(*this + n); }
+
+        bool operator==(const const_iterator& other) const { return pos_ == other.pos_ && keys_ == other.keys_; }
+        bool operator!=(const const_iterator& other) const { return !operator==(other); }
+        bool operator<(const const_iterator& other) const { return pos_ < other.pos_; }
+        bool operator>(const const_iterator& other) const { return pos_ > other.pos_; }
+        bool operator<=(const const_iterator& other) const { return pos_ <= other.pos_; }
+        bool operator>=(const const_iterator& other) const { return pos_ >= other.pos_; }
+
+    private:
+        const FactoryKey* keys_;
+        const ResourceList* commands_;
+        size_t pos_;
+    };
+
 private:
-    PairList<FactoryKey, ResourceList> stops_; // list allocated to factory
+    // parallel arrays, stop i visits keys_[i] and executes commands_[i]
+    SmallVector<FactoryKey, INLINE_STOPS> keys_;
+    SmallVector<ResourceList, INLINE_STOPS> commands_;
+
+    // the information functions, computed together the first time
+    // one of them is asked for after the route changes
+    struct Metrics {
+        ResourceList carryover;
+        Dist length;
+        double carry_time;
+        Quant peak_capacity;
+    };
+    mutable Metrics metrics_;
+    // state of metrics_. Routes are shared between Network copies on different
+    // threads, so the first reader computes them and any others wait for it.
+    enum MetricsState : uint8_t { STALE, STALE_KEEP_LENGTH, COMPUTING, READY };
+    mutable std::atomic<uint8_t> metrics_state_;
+
+    const Metrics& metrics() const;
+    void computeMetrics(bool length) const;
+    // marks the metrics out of date, keep_length if only commands or the start changed
+    void invalidate(bool keep_length = false);
 public:
     // constuctor
     // must specify at least 2 initial factory visits
@@ -49,12 +121,22 @@ public:
     // construct a Route with two stops, optional resourceLists
     Route(FactoryKey from, FactoryKey to, ResourceList fromResourceList = ResourceList(), ResourceList toResourceList = ResourceList());
 
-    // const_iterator getters for the internal container of stops
-    //   iterator dereferences to std::pair<FactoryKey, ResourceList>
+    Route(const Route& other);
+    Route(Route&& other);
+    Route& operator=(const Route& other);
+    Route& operator=(Route&& other);
+
+    // const_iterator getters for the stops
+    //   iterator dereferences to std::pair<const FactoryKey&, const ResourceList&>
     //   so cbegin()->first gets key of first factory
-    //   and cend()-second gets RL of first factory
-    PairList<FactoryKey, ResourceList>::const_iterator cbegin() const;
-    PairList<FactoryKey, ResourceList>::const_iterator cend() const;
+    //   and cbegin()->second gets RL of first factory
+    const_iterator cbegin() const;
+    const_iterator cend() const;
+
+    // the stop keys and commands as contiguous arrays of size() elements,
+    // invalidated by adding or dropping stops
+    const FactoryKey* stopKeys() const;
+    const ResourceList* stopCommands() const;
 
     // adds the stop to stops_
     // warning: does not check if the given factory can produce or accept the given resourceList.
@@ -69,6 +151,7 @@ public:
 
     // returns the key of the factory at the given stop index in the route
     // Use to iterate over all stops in a Route
+    // the key may be changed through the reference, so this marks the metrics out of date
     FactoryKey& operator[](size_t index);
 
     // Get the resourceList of a stop.
@@ -103,6 +186,7 @@ public:
 
     /////////////////////////////////////////////////////////////////
     // Information functions
+    // cached, O(s * R) after the route changes and O(1) after that
     /////////////////////////////////////////////////////////////////
 
     // Calculates which resources are effectively "carried over" from one cycle of the route to the next
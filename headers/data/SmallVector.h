@@ -0,0 +1,161 @@
+/*
+SmallVector declaration
+
+A vector of trivially copyable values that keeps its first few
+elements inside the object, so short lists (like most Routes) never
+touch the heap. Elements are contiguous either way and inserts and
+erases shift them with memmove.
+*/
+
+#ifndef SMALL_VECTOR_H
+#define SMALL_VECTOR_H
+
+/////////////////
+// Includes
+/////////////////
+
+#include <cstring>
+#include <cstdlib>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <stddef.h>
+
+/////////////////
+// SmallVector Class
+/////////////////
+
+// Holds up to Inline elements without allocating.
+template <typename T, size_t Inline>
+class SmallVector {
+    static_assert(std::is_trivially_copyable<T>::value, "SmallVector moves elements with memmove");
+    static_assert(Inline > 0, "SmallVector needs room for at least one inline element");
+
+private:
+    T* data_;
+    size_t size_, capacity_;
+    typename std::aligned_storage<sizeof(T), alignof(T)>::type inline_[Inline];
+
+    T* inlineData() { return reinterpret_cast<T*>(inline_); }
+    bool isInline() const { return data_ == reinterpret_cast<const T*>(inline_); }
+
+    // copies other's elements into this, which must be empty
+    void copyFrom(const SmallVector& other)
+    {
+        reserve(other.size_);
+        std::memcpy(static_cast<void*>(data_), other.data_, other.size_ * sizeof(T));
+        size_ = other.size_;
+    }
+
+    // takes other's heap block, or copies its inline elements. this must be inline and empty
+    void moveFrom(SmallVector& other)
+    {
+        if (other.isInline())
+        {
+            copyFrom(other);
+        }
+        else
+        {
+            data_ = other.data_;
+            size_ = other.size_;
+            capacity_ = other.capacity_;
+            other.data_ = other.inlineData();
+            other.capacity_ = Inline;
+        }
+        other.size_ = 0;
+    }
+
+    void release()
+    {
+        if (!isInline()) {std::free(data_);}
+        data_ = inlineData();
+        size_ = 0;
+        capacity_ = Inline;
+    }
+
+public:
+    typedef T value_type;
+    typedef T* iterator;
+    typedef const T* const_iterator;
+
+    SmallVector() : data_(inlineData()), size_(0), capacity_(Inline) {}
+    SmallVector(const SmallVector& other) : SmallVector() { copyFrom(other); }
+    SmallVector(SmallVector&& other) noexcept : SmallVector() { moveFrom(other); }
+    ~SmallVector() { release(); }
+
+    SmallVector& operator=(const SmallVector& other)
+    {
+        if (this != &other)
+        {
+            size_ = 0;
+            copyFrom(other);
+        }
+        return *this;
+    }
+    SmallVector& operator=(SmallVector&& other) noexcept
+    {
+        if (this != &other)
+        {
+            release();
+            moveFrom(other);
+        }
+        return *this;
+    }
+
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    size_t capacity() const { return capacity_; }
+
+    T* data() { return data_; }
+    const T* data() const { return data_; }
+    T* begin() { return data_; }
+    T* end() { return data_ + size_; }
+    const T* begin() const { return data_; }
+    const T* end() const { return data_ + size_; }
+
+    T& operator[](size_t i) { return data_[i]; }
+    const T& operator[](size_t i) const { return data_[i]; }
+    T& back() { return data_[size_ - 1]; }
+    const T& back() const { return data_[size_ - 1]; }
+
+    // makes room for n elements
+    void reserve(size_t n)
+    {
+        if (n <= capacity_) {return;}
+        size_t capacity = capacity_ * 2 > n ? capacity_ * 2 : n;
+        T* data = static_cast<T*>(std::malloc(capacity * sizeof(T)));
+        if (!data) {throw std::bad_alloc();}
+        std::memcpy(static_cast<void*>(data), data_, size_ * sizeof(T));
+        if (!isInline()) {std::free(data_);}
+        data_ = data;
+        capacity_ = capacity;
+    }
+
+    void clear() { size_ = 0; }
+
+    void push_back(const T& value)
+    {
+        insert(size_, value);
+    }
+
+    // puts value before position i, i <= size()
+    void insert(size_t i, const T& value)
+    {
+        if (i > size_) {throw std::out_of_range("SmallVector insert past the end");}
+        T copy = value; // value may live in this vector
+        reserve(size_ + 1);
+        std::memmove(static_cast<void*>(data_ + i + 1), data_ + i, (size_ - i) * sizeof(T));
+        data_[i] = copy;
+        size_++;
+    }
+
+    // removes the element at position i, i < size()
+    void erase(size_t i)
+    {
+        if (i >= size_) {throw std::out_of_range("SmallVector erase past the end");}
+        std::memmove(static_cast<void*>(data_ + i), data_ + i + 1, (size_ - i - 1) * sizeof(T));
+        size_--;
+    }
+};
+
+#endif
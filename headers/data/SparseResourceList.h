@@ -0,0 +1,100 @@
+/*
+SparseResourceList declaration
+
+A ResourceList that only stores the resources it actually uses: a
+bitmask of the nonzero resources plus their Quants packed in resource
+order. Most commands and edges only touch a few resources, so they
+take less memory this way, and working through one only visits the
+resources that are set.
+*/
+
+#ifndef SPARSE_RESOURCE_LIST_H
+#define SPARSE_RESOURCE_LIST_H
+
+/////////////////
+// Includes
+/////////////////
+
+#include "ResourceList.h"
+#include <memory>
+
+/////////////////
+// BasicSparseResourceList Class
+/////////////////
+
+// Holds the same information as a BasicResourceList<N>, converting
+// between the two is lossless.
+// Up to INLINE_CAPACITY resources are stored inside the object, more
+// than that are stored in one heap block.
+// Only N = Resource::COUNT is instantiated (in SparseResourceList.cpp).
+template <size_t N>
+class BasicSparseResourceList {
+public:
+    static const size_t NUM_RESOURCES = N;
+    static const size_t INLINE_CAPACITY = 4;
+
+private:
+    uint64_t mask_;                  // bit r is set if resource r is nonzero
+    Quant inline_[INLINE_CAPACITY];  // the nonzero Quants, if there are few enough
+    std::unique_ptr<Quant[]> spill_; // the nonzero Quants otherwise
+
+    const Quant* values() const;
+    Quant* values();
+    // index of resource r among the packed Quants
+    size_t rank(size_t r) const;
+    // replaces the contents with mask and its packed Quants
+    void assign(uint64_t mask, const Quant* packed);
+
+public:
+    BasicSparseResourceList();
+    explicit BasicSparseResourceList(const BasicResourceList<N>& dense);
+    BasicSparseResourceList(const BasicSparseResourceList& other);
+    BasicSparseResourceList& operator=(const BasicSparseResourceList& other);
+    // other is left empty
+    BasicSparseResourceList(BasicSparseResourceList&& other) noexcept;
+    BasicSparseResourceList& operator=(BasicSparseResourceList&& other) noexcept;
+
+    // Quant of resource r, 0 if it isn't set
+    //   if r isn't in the list, throw out_of_range
+    Quant operator[](size_t r) const;
+    // sets resource r to q, setting 0 removes it
+    //   if r isn't in the list, throw out_of_range
+    void set(size_t r, Quant q);
+
+    // bit r is set if resource r is nonzero, negative or positive
+    uint64_t mask() const;
+    uint64_t negativeMask() const;
+    uint64_t positiveMask() const;
+    // number of nonzero resources
+    size_t count() const;
+    bool isEmpty() const;
+    // sum of all Quants
+    Quant total() const;
+
+    BasicResourceList<N> toDense() const;
+    // dense += this and dense -= this, only visiting the set resources
+    void addTo(BasicResourceList<N>& dense) const;
+    void subtractFrom(BasicResourceList<N>& dense) const;
+    // every Quant negated
+    BasicSparseResourceList negated() const;
+
+    bool operator==(const BasicSparseResourceList& other) const;
+
+    // calls visit(r, q) for every nonzero resource, in increasing r
+    template <typename Visit>
+    void forEach(Visit visit) const
+    {
+        const Quant* v = values();
+        for (uint64_t m = mask_; m; m &= m - 1)
+        {
+            visit(size_t(__builtin_ctzll(m)), *v++);
+        }
+    }
+};
+
+// sparse counterpart of ResourceList
+typedef BasicSparseResourceList<Resource::COUNT> SparseResourceList;
+
+extern template class BasicSparseResourceList<Resource::COUNT>;
+
+#endif
@@ -0,0 +1,54 @@
+/*
+SpatialIndex declaration
+
+A uniform grid over a set of Locations that answers radius and
+k-nearest queries in the octile metric used by dist(). Lets solvers
+look at nearby factories instead of every pair of factories.
+*/
+
+#ifndef SPATIAL_INDEX_H
+#define SPATIAL_INDEX_H
+
+/////////////////
+// Includes
+/////////////////
+
+#include "Location.h"
+#include <vector>
+#include <stddef.h>
+
+/////////////////
+// SpatialIndex Class
+/////////////////
+
+// Points are referred to by their index in the vector the index was built from.
+// The index is immutable once built.
+class SpatialIndex {
+private:
+    std::vector<Location> locs_;
+    Coord min_x_, min_y_;
+    int64_t cell_;          // side length of a grid cell
+    int64_t cols_, rows_;
+    // points bucketed by cell, the points of cell c are
+    // items_[cell_start_[c]] to items_[cell_start_[c+1]]
+    std::vector<uint32_t> cell_start_;
+    std::vector<uint32_t> items_;
+
+    int64_t cellX(int64_t x) const; // not clamped to the grid
+    int64_t cellY(int64_t y) const;
+
+public:
+    // cell_size = 0 picks a size that puts about one point in each cell
+    SpatialIndex(const std::vector<Location>& locs = std::vector<Location>(), Coord cell_size = 0);
+
+    size_t size() const;
+    const Location& getLoc(size_t i) const;
+
+    // indices of all points with dist(center, point) <= radius, in increasing order
+    std::vector<size_t> withinRadius(Location center, Dist radius) const;
+    // indices of the k points nearest to center, nearest first
+    // equally near points are ordered by index
+    std::vector<size_t> kNearest(Location center, size_t k) const;
+};
+
+#endif
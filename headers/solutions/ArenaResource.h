@@ -0,0 +1,85 @@
+/*
+ArenaResource declaration
+
+Memory resources for the short lived containers the solvers make by the
+million. An ArenaResource hands out memory by bumping a pointer through
+large blocks and frees it all at once when it is reset, so a generation
+or polishing iteration costs a few block allocations instead of one heap
+allocation per container. Both resources count what they hand out, so a
+solve can report how much memory it churned through.
+*/
+
+#ifndef ARENA_RESOURCE_H
+#define ARENA_RESOURCE_H
+
+/////////////////
+// Includes
+/////////////////
+
+#include <memory_resource>
+#include <stddef.h>
+
+/////////////////
+// Definitions
+/////////////////
+
+// allocations made through a resource, and what it took from its upstream
+struct MemoryStats {
+    size_t allocations = 0;
+    size_t bytes = 0;
+    size_t upstream_allocations = 0;
+    size_t upstream_bytes = 0;
+
+    MemoryStats& operator+=(const MemoryStats& other);
+};
+
+/////////////////
+// Resource Classes
+/////////////////
+
+// Passes every allocation on to upstream, counting them.
+// Not thread safe, use one per thread.
+class CountingResource : public std::pmr::memory_resource {
+private:
+    std::pmr::memory_resource* upstream_;
+    MemoryStats stats_;
+
+    void* do_allocate(size_t bytes, size_t alignment) override;
+    void do_deallocate(void* p, size_t bytes, size_t alignment) override;
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+public:
+    explicit CountingResource(std::pmr::memory_resource* upstream = std::pmr::new_delete_resource());
+
+    // counted since construction or the last takeStats
+    const MemoryStats& getStats() const;
+    // returns the counts and starts counting from 0
+    MemoryStats takeStats();
+};
+
+// Deallocating is free and does nothing, the memory is only given back
+// by reset(). Anything allocated from the arena must be destroyed before
+// it is reset. Not thread safe, use one per thread.
+class ArenaResource : public std::pmr::memory_resource {
+private:
+    CountingResource upstream_;
+    std::pmr::monotonic_buffer_resource arena_;
+    MemoryStats stats_;
+
+    void* do_allocate(size_t bytes, size_t alignment) override;
+    void do_deallocate(void* p, size_t bytes, size_t alignment) override;
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+public:
+    explicit ArenaResource(std::pmr::memory_resource* upstream = std::pmr::new_delete_resource());
+
+    // frees everything allocated so far
+    void reset();
+
+    // counted since construction or the last takeStats
+    MemoryStats getStats() const;
+    // returns the counts and starts counting from 0
+    MemoryStats takeStats();
+};
+
+#endif
@@ -0,0 +1,94 @@
+/*
+BatchSolver declaration
+
+Solves many networks with the same SolverConfig on a pool of workers,
+for jobs like re-planning every outpost of a base at once. Each job
+loads its network only when a worker picks it up, and its result is
+handed back as soon as it is solved and then dropped, so memory grows
+with the number of workers rather than the number of networks. Each
+worker keeps one memory pool for the whole batch, so the solvers'
+scratch arenas reuse the blocks of earlier jobs instead of going back
+to the heap.
+*/
+
+#ifndef BATCH_SOLVER_H
+#define BATCH_SOLVER_H
+
+/////////////////
+// Includes
+/////////////////
+
+#include "SolverConfig.h"
+#include <functional>
+#include <string>
+#include <vector>
+
+/////////////////
+// Results
+/////////////////
+
+struct BatchResult {
+    size_t index;       // position of the job in the batch
+    std::string name;
+    Network solution;   // empty if the job failed
+    bool valid;         // solution passes the config's constraints
+    Cost cost;
+    long long load_us;  // wall time to load the network
+    long long solve_us; // wall time to build the solver and solve
+    long long solve_cpu_us; // CPU time of the worker over the same span. With config.threads > 1
+                            // the solver's own pool threads aren't counted
+    std::string error;  // what the job threw, empty if it succeeded
+};
+
+struct BatchStats {
+    size_t solved = 0;
+    size_t failed = 0;
+    long long wall_us = 0; // of the whole batch
+    long long solve_cpu_us = 0; // sum of the jobs' solve_cpu_us
+    MemoryStats memory;    // allocations made by the solvers' short lived containers
+    // jobs finished per second of the batch
+    double networksPerSecond() const;
+    // solve CPU time per solved job, 0 if none were solved
+    double cpuMicrosPerNetwork() const;
+};
+
+/////////////////
+// BatchSolver Class
+/////////////////
+
+class BatchSolver {
+public:
+    // makes the network of a job, called on the worker that solves it
+    typedef std::function<Network()> Loader;
+    typedef std::function<void(const BatchResult&)> ResultHandler;
+
+private:
+    struct Job {
+        std::string name;
+        Loader load;
+    };
+    SolverConfig config_;
+    size_t num_workers_;
+    std::vector<Job> jobs_;
+
+public:
+    // workers = 0 uses every hardware thread. Each job's solver runs on
+    // config.threads threads of its own, 1 is usually best in a batch.
+    BatchSolver(const SolverConfig& config, size_t workers = 0);
+
+    // load is called once, on a worker thread, and may run at the same
+    // time as other jobs' loaders
+    void add(const std::string& name, Loader load);
+    // keeps a copy of net until its job is done
+    void add(const std::string& name, const Network& net);
+    size_t size() const;
+
+    // solves every job added so far. on_result is called once per job as it
+    // finishes, in the order they finish, one call at a time.
+    // A job that throws is reported with its error and the batch goes on.
+    // Jobs are removed once they have run.
+    //   if on_result throws, the batch stops and the exception is rethrown
+    BatchStats run(const ResultHandler& on_result);
+};
+
+#endif
@@ -79,31 +79,32 @@ CANON_DUAL_RES_PRODUCE((std::vector<Factory>) {
     )
 }), 
 // CANON_TWO_ZONES - two zones, each of which contains factories which would 
+//   only uses the first three resources, like the other examples
 CANON_TWO_ZONES((std::vector<Factory>) {
     Factory(
         (Location){0, 0}, 
         ResourceList((std::map<Resource, Quant>) {
             {Resource::Copper, -4},
-            {Resource::Circuits, 2}
+            {Resource::Steel, 2}
         })
     ), Factory(
         (Location){0, 2}, 
         ResourceList((std::map<Resource, Quant>) {
-            {Resource::Uranium, -1},
-            {Resource::NuclearFuel, 4}
+            {Resource::Iron, -1},
+            {Resource::Steel, 4}
         })
     ),
     Factory(
         (Location){100, 0}, 
         ResourceList((std::map<Resource, Quant>) {
             {Resource::Copper, 4},
-            {Resource::Circuits, -2}
+            {Resource::Steel, -2}
         })
     ), Factory(
         (Location){100, 2}, 
         ResourceList((std::map<Resource, Quant>) {
-            {Resource::Uranium, 1},
-            {Resource::NuclearFuel, -4}
+            {Resource::Iron, 1},
+            {Resource::Steel, -4}
         })
     )
 }), CANON_TRI_CYCLE((std::vector<Factory>) {
@@ -48,6 +48,11 @@ struct Constraints {
     // all constraints on a solution
     bool isValidSolution(const Network& net) const;
 
+    // same answer as isValidSolution in O(1), using the
+    // deficit and repeated stop counts the Network keeps
+    // up to date as it is edited
+    bool quickCheck(const Network& net) const;
+
     // Check that all routes leave all factories
     // a constraint that we have is that a route
     // cannot have the same factory twice in a row
@@ -22,7 +22,10 @@ This file defines several cost functions and metrics.
 #include <stdint.h>
 #include <array>
 #include <map>
+#include <set>
+#include <string_view>
 #include "../data/Network.h"
+#include "../data/HashCounter.h"
 
 /////////////////
 // Definitions
@@ -30,6 +33,28 @@ This file defines several cost functions and metrics.
 
 typedef double Cost;
 
+// a stretch of track between two consecutive stops of a route
+// see CostFunct::undirected_track for which way round it is stored
+typedef std::pair<FactoryKey, FactoryKey> EdgeKey;
+
+struct EdgeKeyHasher {
+    size_t operator()(const EdgeKey& key) const noexcept;
+};
+
+// how many times each edge is used by the routes of a network
+typedef HashCounter<EdgeKey, EdgeKeyHasher> EdgeCounter;
+
+// Describes a change to the routes of a network, so that the change can
+// be scored without re-evaluating the whole network.
+// RouteKeys refer to the network before the edit. The edit is applied by
+// first replacing routes in place, then erasing routes, then appending the
+// added routes to the end (the same order Network uses for its routes).
+struct NetworkEdit {
+    std::vector<std::pair<RouteKey, Route>> replaced; // route at key becomes the given route
+    std::vector<RouteKey> erased;                     // routes removed from the network
+    std::vector<Route> added;                         // routes appended to the network
+};
+
 /////////////////
 // Cost function base
 /////////////////
@@ -85,6 +110,38 @@ struct CostFunct
     // array of weights for each metric
     std::array<double, Metric::COUNT> weights;
 
+    // false: track from a to b and track from b to a are different edges,
+    //   so routes running the same track in opposite directions don't share it
+    // true: an edge is the track between two places whichever way it is run,
+    //   (a route going out and back along a track uses it twice)
+    // Applies to the track metrics, the track length map and the cost cache.
+    bool undirected_track;
+
+    // metrics of a single route, cached so they are only computed once
+    struct RouteMetrics {
+        std::vector<FactoryKey> stops; // needed to take the route's edges back out
+        Dist length;
+        double carry_time;
+        Quant peak_capacity;
+    };
+
+    // Cached state of a network used for incremental cost evaluation.
+    // Build with buildCache(), then score edits with delta() and commit
+    // them with apply(). Keeps the per-route metrics and a persistent
+    // table of how many times each edge is traversed, so an edit only
+    // costs time proportional to the routes it touches.
+    struct CostCache {
+        std::vector<RouteMetrics> routes;   // mirrors the order of the network's routes
+        EdgeCounter edge_mult;              // times each edge is traversed
+        Dist base_track, shared_track;      // sum of d over used edges, sum of d*(mult-1)
+        std::multiset<Dist> lengths;
+        std::multiset<double> carry_times;
+        std::multiset<Quant> peak_capacities;
+        double total_carry_time;
+        Quant total_peak_capacity;
+        size_t num_junctions;
+    };
+
     // base constructor
     CostFunct();
     // argumented constructor
@@ -94,20 +151,68 @@ struct CostFunct
     // individual metric functions
     size_t getNumJunctions(const Network& net) const;
     std::map<size_t, Dist> getTrackLengthMap(const Network& net) const;
+    // sum of the length of every used edge, and of each length times the
+    // number of additional routes using it. What BaseTrackLength and
+    // SharedTrackLength are charged for.
+    void getTrackLengths(const Network& net, Dist& base_track, Dist& shared_track) const;
     Dist getMaxLength(const Network& net) const;
     size_t getNumRoutes(const Network& net) const;
     double getMaxCarryTime(const Network& net) const;
     double getTotalCarryTime(const Network& net) const;
     Quant getMaxPeakCapacity(const Network& net) const;
     Quant getTotalPeakCapacity(const Network& net) const;
+    // every metric of net in its units, so the cost of net is the
+    // sum of weights[m] * values[m]
+    std::array<double, Metric::COUNT> getMetricValues(const Network& net) const;
 
     // calculate cost of network
     Cost operator()(const Network& net) const;
     // Cost getMetric(Metric m, const Network& net) const;
+
+    // incremental evaluation
+    // O(r * f_r + r log r)
+    CostCache buildCache(const Network& net) const;
+    // cost of the network described by the cache
+    // O(1)
+    Cost operator()(const CostCache& cache) const;
+    // change in cost if edit were applied, does not modify the cache
+    // O(e * (f_r + log r))   e - number of routes touched by the edit
+    // edges are counted in hash tables, so this is on average
+    Cost delta(const CostCache& cache, const NetworkEdit& edit) const;
+    // commits edit to the cache and returns the new cost
+    // O(e * (f_r + log r) + r)
+    Cost apply(CostCache& cache, const NetworkEdit& edit) const;
+
+private:
+    // totals of a cache after an edit, shared by delta and apply
+    struct EditTotals {
+        Dist base_track, shared_track, max_length;
+        double max_carry_time, total_carry_time;
+        Quant max_peak_capacity, total_peak_capacity;
+        size_t num_routes, num_junctions;
+    };
+    EdgeKey edgeKey(FactoryKey from, FactoryKey to) const;
+    // calls visit(edge) for every edge of the closed route through the n stops,
+    // starting with the edge from the last stop back to the first
+    template <typename Visit>
+    void forEachEdge(const FactoryKey* stops, size_t n, Visit visit) const;
+    template <typename Visit>
+    void forEachEdge(const std::vector<FactoryKey>& stops, Visit visit) const;
+    // counts the edges of every route of net into counter, which is cleared first
+    void countEdges(const Network& net, EdgeCounter& counter) const;
+    RouteMetrics getRouteMetrics(const Route& route) const;
+    EditTotals evaluateEdit(const CostCache& cache, const NetworkEdit& edit, const std::vector<RouteMetrics>& new_metrics) const;
+    Cost totalsCost(const EditTotals& totals) const;
 };
 
 // increment operators for Metric enum
 CostFunct::Metric& operator++(CostFunct::Metric& m);
 CostFunct::Metric operator++(CostFunct::Metric& m, int);
+// name of a metric as it is spelled in the enum, like "MaxLength"
+//   if m isn't a metric, throw out_of_range
+const char* metricName(CostFunct::Metric m);
+// finds the metric called name, ignoring case and any '_', '-' or ' ' (see sameName)
+//   returns false if no metric has that name
+bool parseMetric(std::string_view name, CostFunct::Metric& m);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,85 @@
+/*
+FactoryImport declaration
+
+Reads the factories of a network from a line oriented text file, like
+the CSV and JSON lines dumps extracted from saves. The text is parsed
+a chunk at a time as it arrives, so the whole file is never held in
+memory, and the places are built into a Network all at once at the end.
+
+Each line is one row, either CSV:
+    x,y[,resource,quant]...
+or a JSON object:
+    {"x": 3, "y": -2, "resources": {"copper-plate": 30, "iron-gear-wheel": -10}}
+Resources are named like parseResource accepts, or by their Factorio
+item names ("copper-plate", "electronic-circuit", ...). A row without
+any resources is a junction. Rows at the same Location are added
+together into one place. Blank lines, lines starting with '#', and a
+CSV header as the first row are skipped.
+*/
+
+#ifndef FACTORY_IMPORT_H
+#define FACTORY_IMPORT_H
+
+/////////////////
+// Includes
+/////////////////
+
+#include "../data/Network.h"
+#include <istream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/////////////////
+// FactoryImporter Class
+/////////////////
+
+// Errors are reported as invalid_argument, with the line they are on.
+class FactoryImporter {
+private:
+    std::vector<Location> locs_;
+    std::vector<ResourceList> quants_;
+    // open addressing index from Location to 1 + its position in locs_, 0 marks
+    // an empty slot. Size is a power of 2, kept at most half full
+    std::vector<size_t> index_;
+    std::string partial_; // the start of a line cut off by the end of a chunk
+    size_t num_lines_;
+    size_t num_rows_;
+
+    void parseLine(const char* begin, const char* end);
+    void parseCsv(std::string_view line);
+    void parseJson(std::string_view line);
+    // adds quant of the resource called name to quants
+    void addQuant(ResourceList& quants, std::string_view name, std::string_view quant) const;
+    void addRow(Location loc, const ResourceList& quants);
+    void growIndex();
+    [[noreturn]] void fail(const std::string& what) const;
+
+public:
+    static const size_t DEFAULT_CHUNK_BYTES = size_t(64) << 10;
+
+    FactoryImporter();
+
+    // parses the next size bytes of the file, lines may be split between chunks
+    void feed(const char* data, size_t size);
+    // parses the last line if the file doesn't end with a newline
+    void finish();
+    // feeds all of in, chunk_bytes at a time, then finishes
+    //   if in can't be read, throw runtime_error
+    void read(std::istream& in, size_t chunk_bytes = DEFAULT_CHUNK_BYTES);
+    //   if the file can't be opened or read, throw runtime_error
+    void readFile(const std::string& path, size_t chunk_bytes = DEFAULT_CHUNK_BYTES);
+
+    size_t getNumLines() const;  // lines parsed so far
+    size_t getNumRows() const;   // lines that held a place
+    size_t getNumPlaces() const; // distinct Locations
+
+    // a Network of every place read so far, O(f log f).
+    //   if validate and Constraints::isValidNetwork fails, throw invalid_argument
+    Network toNetwork(bool validate = true) const;
+};
+
+// reads the factory file at path into a Network
+Network importFactories(const std::string& path, bool validate = true);
+
+#endif
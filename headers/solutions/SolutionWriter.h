@@ -0,0 +1,106 @@
+/*
+SolutionWriter declaration
+
+Writes a solved network to a file: every route with its stops, the
+command at each stop and its metrics, and the breakdown of its cost by
+metric. Records are written to the file as they are given, so a
+solution with many routes is never held in memory as one big string.
+
+There are two formats. JSON lines has one object per line:
+    {"type": "cost", "cost": 12.5, "metrics": {"NumJunctions": {"value": 0, "weight": 1, "cost": 0}, ...}}
+    {"type": "route", "route": 0, "length": 4.24, "carry_time": 8.4, "peak_capacity": 2,
+     "stops": [{"x": 0, "y": 0, "command": {"Copper": 2}}, ...]}
+Commands only list their nonzero resources, by resourceName.
+
+The binary format is a SolutionFileHeader followed by records, all
+little endian. Each record starts with a SolutionRecordHeader:
+    ROUTE: SolutionRouteRecord, Location stops[num_stops], ResourceList commands[num_stops]
+    COST:  double total, then SolutionMetricRecord[num_metrics] in Metric order
+*/
+
+#ifndef SOLUTION_WRITER_H
+#define SOLUTION_WRITER_H
+
+/////////////////
+// Includes
+/////////////////
+
+#include "CostFunct.h"
+#include <fstream>
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+/////////////////
+// Binary Format
+/////////////////
+
+namespace SolutionFile {
+    const char MAGIC[8] = {'F', 'A', 'C', 'T', 'S', 'O', 'L', '\0'};
+    // bumped whenever the layout changes
+    const uint32_t VERSION = 1;
+    enum RecordKind : uint32_t { ROUTE = 1, COST = 2 };
+}
+
+struct SolutionFileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t num_resources; // Resource::COUNT, the length of each command
+};
+
+struct SolutionRecordHeader {
+    uint32_t kind;  // a SolutionFile::RecordKind
+    uint32_t count; // stops of a route, metrics of a cost
+};
+
+// lengths are stored exactly, as rat_ + irrat_ * sqrt(2)
+struct SolutionRouteRecord {
+    uint32_t route;
+    int32_t length_rat;
+    int32_t length_irrat;
+    int32_t peak_capacity;
+    double carry_time;
+};
+
+struct SolutionMetricRecord {
+    double value;
+    double weight;
+};
+
+/////////////////
+// SolutionWriter Class
+/////////////////
+
+class SolutionWriter {
+public:
+    enum Format { BINARY, JSON_LINES };
+
+private:
+    std::vector<char> buffer_; // out_'s buffer, bigger than the default, has to outlive it
+    std::ofstream out_;
+    Format format_;
+    size_t num_routes_;
+
+    void writeBytes(const void* bytes, size_t size);
+
+public:
+    //   if the file can't be opened, throw runtime_error
+    SolutionWriter(const std::string& path, Format format);
+
+    // O(s * R)
+    void writeRoute(RouteKey key, const Route& route);
+    // the value, weight and weighted cost of every metric of cost for net
+    void writeCost(const CostFunct& cost, const Network& net);
+
+    // flushes and closes the file, the destructor closes it without checking
+    //   if anything couldn't be written, throw runtime_error
+    void close();
+
+    size_t getNumRoutes() const; // routes written so far
+};
+
+// writes the cost breakdown of net and then each of its routes
+//   if the file can't be written, throw runtime_error
+void writeSolution(const Network& net, const CostFunct& cost, const std::string& path, SolutionWriter::Format format);
+
+#endif
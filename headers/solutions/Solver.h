@@ -16,20 +16,99 @@ maximize efficiency and minimize cost
 /////////////////
 
 #include "../data/Network.h"
+#include "../data/SparseResourceList.h"
 #include "CostFunct.h"
 #include "Constraints.h"
+#include "ArenaResource.h"
 #include <vector>
+#include <memory>
+#include <memory_resource>
+#include <random>
+#include <functional>
 
 /////////////////
 // Solver Class
 /////////////////
 
 class Solver {
+    public:
+        // a route between two factories that the finishers may add
+        struct FinishEdge {
+            FactoryKey start, end;
+            SparseResourceList rl; // edges trade only a few resources
+            double prio;
+        };
+        // default weights of distance and quantity when ranking finish edges
+        static constexpr double DEFAULT_DIST_W = 1.0;
+        static constexpr double DEFAULT_QUANT_W = 3.0;
+
     protected:
         Network network;
         CostFunct cost;
         Constraints constraints;
 
+        // number of threads a solve may use, 0 uses every hardware thread
+        size_t num_threads;
+        // runs with the same seed give the same result, whatever num_threads is
+        uint64_t seed;
+
+        // random number stream of the calling thread. Solvers use this rather
+        // than rand() so that work can run on several threads reproducibly.
+        static std::mt19937& rng();
+        static uint32_t randomInt();
+        // restarts the calling thread's stream, seeded by seed and a task's indices
+        static void seedRng(uint64_t seed, uint64_t a, uint64_t b = 0);
+
+        // memory for the short lived containers of the calling thread,
+        // the default resource unless a ScratchScope is active on it
+        static std::pmr::memory_resource* scratch();
+        // points scratch() at mem until the scope ends. Tasks on the thread
+        // pool open one on their arena, like they seed rng().
+        class ScratchScope {
+            public:
+                explicit ScratchScope(std::pmr::memory_resource* mem);
+                ~ScratchScope();
+                ScratchScope(const ScratchScope&) = delete;
+                ScratchScope& operator=(const ScratchScope&) = delete;
+            private:
+                std::pmr::memory_resource* prev;
+        };
+
+        // where arenas get their blocks from, see setMemoryResource
+        std::pmr::memory_resource* memory_upstream;
+        // one arena per task of a parallelFor. Reset between generations or
+        // polishing iterations, once nothing allocated from them is alive.
+        std::vector<std::unique_ptr<ArenaResource>> arenas;
+        // what the last solve allocated through its arenas
+        MemoryStats memory_stats;
+        // adds the arenas' counts to memory_stats, resets them,
+        // and makes sure there are at least n
+        void resetArenas(size_t n);
+
+        // limits which factory pairs get finish edges, see setEdgeNeighbourhood
+        size_t edge_k;
+        Dist edge_radius;
+
+        // calls visit(a, b) for each pair of places that may get a finish edge,
+        // with a before b in Location order. Pairs are visited in the same order
+        // as a loop over every pair would visit them.
+        // O(f^2) for every pair, O(f * R * k log k) with a neighbourhood
+        void forEachEdgeCandidate(const std::function<void(FactoryId, FactoryId)>& visit) const;
+        // builds the edge between places a and b of net, weighing distance against
+        // the quantity they can trade. Returns false if they can't trade anything.
+        bool makeFinishEdge(const Network& net, FactoryId a, FactoryId b, double dist_w, double quant_w, FinishEdge& edge) const;
+        // sorts edges by descending prio, giving the same order as inserting them one at
+        // a time with a lower_bound: equal prio edges end up in reverse order of addition
+        // O(E log E)
+        static void sortFinishEdges(std::vector<FinishEdge>& edges);
+        // adds a route for as much of edge as nn's factories can still execute
+        // returns false if nothing could be added
+        bool addFinishRoute(Network& nn, const FinishEdge& edge) const;
+        // finishes nn by linking each factory with a deficit to its nearest partners.
+        // used when an edge list built with a neighbourhood runs out of edges.
+        // O(d * f log f), d factories with a deficit
+        void finishFromNearest(Network& nn) const;
+
     public:
         // constructor
         Solver(const Network& net, const CostFunct cos, const Constraints constr);
@@ -52,11 +131,37 @@ class Solver {
         // numberJunctions is the number of junctions you want to return. essentially "give me the best n junctions". To include everything, 
         // set this to network.size()*6. Ask Andrew for why.
         // will not include locations already in the network.
-        std::vector<std::pair<Location, int>> junctionFunction(size_t numberJunctions);
+        // radius limits the pairs to factories at most radius apart, Dist{0, 0} uses every pair.
+        // Pairs are counted on getThreads() threads, the output doesn't depend on the thread count.
+        std::vector<std::pair<Location, int>> junctionFunction(size_t numberJunctions, Dist radius = Dist{0, 0});
 
         // getter
         const Network& getNet() const;
 
+        // Edge generation normally considers every pair of factories, which is
+        // O(f^2). With a neighbourhood, a pair is only considered if
+        //   k > 0: one of them is among the k nearest factories to the other
+        //          that can trade some resource with it, and
+        //   radius > 0: they are at most radius apart.
+        // If a small neighbourhood runs out of edges, the finishers link the
+        // remaining deficits to their nearest partners.
+        // Takes effect the next time the edge list is generated.
+        void setEdgeNeighbourhood(size_t k, Dist radius = Dist{0, 0});
+
+        // memory
+        // arenas take their blocks from upstream, which must outlive the solver
+        // and be thread safe (like synchronized_pool_resource). new and delete
+        // are used by default.
+        void setMemoryResource(std::pmr::memory_resource* upstream);
+        // allocations made by the last solve's short lived containers
+        const MemoryStats& getMemoryStats() const;
+
+        // threading and randomness
+        void setThreads(size_t n);
+        size_t getThreads() const;
+        void setSeed(uint64_t s);
+        uint64_t getSeed() const;
+
 };
 
 #endif
\ No newline at end of file
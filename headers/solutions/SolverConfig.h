@@ -0,0 +1,51 @@
+/*
+SolverConfig declaration
+
+Everything needed to build a solver for a network, chosen at run time:
+which solver, its parameters, the cost function, the thread count and
+the seed. Lets drivers like main.cpp pick solvers without recompiling.
+*/
+
+#ifndef SOLVER_CONFIG_H
+#define SOLVER_CONFIG_H
+
+/////////////////
+// Includes
+/////////////////
+
+#include "Solver.h"
+#include <memory>
+#include <string_view>
+
+/////////////////
+// SolverConfig Struct
+/////////////////
+
+struct SolverConfig {
+    enum Algorithm { GREEDY_EDGE_LIST, GENETIC };
+
+    Algorithm algorithm;
+    double dist_w, quant_w; // weights of distance and quantity when ranking finish edges
+    size_t track;           // GreedyEdgeList only, networks tracked while polishing
+    size_t num_iters;       // Genetic only, generations to run
+    CostFunct cost;
+    Constraints constraints;
+    size_t threads;         // 0 uses every hardware thread
+    uint64_t seed;
+
+    // GreedyEdgeList with the defaults of the solver constructors,
+    // ALL_COSTS, one thread and the Solver's default seed
+    SolverConfig();
+
+    // a solver for net, with its edge list already generated
+    std::unique_ptr<Solver> makeSolver(const Network& net) const;
+};
+
+// name of an algorithm, like "GreedyEdgeList"
+//   if a isn't an algorithm, throw out_of_range
+const char* algorithmName(SolverConfig::Algorithm a);
+// finds the algorithm called name, ignoring case and any '_', '-' or ' ' (see sameName)
+//   returns false if no algorithm has that name
+bool parseAlgorithm(std::string_view name, SolverConfig::Algorithm& a);
+
+#endif
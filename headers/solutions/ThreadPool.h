@@ -0,0 +1,64 @@
+/*
+ThreadPool declaration
+
+A small fixed size pool of worker threads used by the solvers to run
+independent pieces of work (children in a generation, polishing tracks)
+concurrently. The calling thread also does work, so a pool of n threads
+starts n-1 workers, and a pool of 1 runs everything inline.
+*/
+
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+/////////////////
+// Includes
+/////////////////
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/////////////////
+// ThreadPool Class
+/////////////////
+
+class ThreadPool {
+public:
+    // num_threads = 0 uses every hardware thread
+    explicit ThreadPool(size_t num_threads);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    size_t size() const;
+
+    // calls body(i) for every i in [0, count), and returns once all calls are done.
+    // Calls may run in any order and on any thread, so body must only write
+    // to data owned by index i. The first exception thrown by body is rethrown here.
+    void parallelFor(size_t count, const std::function<void(size_t)>& body);
+
+private:
+    std::vector<std::thread> workers_;
+
+    std::mutex mutex_;
+    std::condition_variable work_ready_, work_done_;
+    bool stopping_;
+    size_t generation_;   // bumped for every parallelFor call, wakes the workers
+    size_t active_;       // workers still working on the current call
+
+    // current call
+    const std::function<void(size_t)>* body_;
+    size_t count_;
+    std::atomic<size_t> next_;
+    std::exception_ptr error_;
+
+    void workerLoop();
+    void runTasks();
+};
+
+#endif
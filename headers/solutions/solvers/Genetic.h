@@ -23,13 +23,6 @@ Derived solver for brute force
 // maybe make in-between Heursitic Solver
 
 class Genetic : public Solver {
-
-    struct FinishEdge {
-        FactoryKey start, end;
-        ResourceList rl;
-        double prio;
-    };
-
     protected:
         size_t num_iters;
         // sorted list of all helpful/possible edges in the network
@@ -41,14 +34,18 @@ class Genetic : public Solver {
             1, 1, 5, 1, 3
         };
     public:
+        // generations to run
+        static constexpr size_t DEFAULT_ITERS = 100;
+
         //////////////
         // construct
         //////////////
-        Genetic(const Network& net, const CostFunct cos, const Constraints constr, size_t iters = 100);
+        // d_w and q_w weigh the edge list, like generateEdgeList's
+        Genetic(const Network& net, const CostFunct cos, const Constraints constr, size_t iters = DEFAULT_ITERS,
+            double d_w = DEFAULT_DIST_W, double q_w = DEFAULT_QUANT_W);
 
         // tools to build out edgelist for completers
-        void addEdge(FinishEdge fe);
-        void generateEdgeList(double DIST_W = 1.0, double QUANT_W = 3.0);
+        void generateEdgeList(double DIST_W = DEFAULT_DIST_W, double QUANT_W = DEFAULT_QUANT_W);
         std::vector<size_t> getRandomEdgeOrdering() const;
         std::vector<RouteKey> getRandomRouteOrdering(const Network& net) const;
 
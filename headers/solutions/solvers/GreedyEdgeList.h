@@ -22,25 +22,34 @@ O(T * r^4 * f_r^2) ~ O(T * r^2 * f^2) complexity
 
 #include "../Solver.h"
 #include <vector>
+#include <list>
+#include <map>
+#include <memory_resource>
 
 /////////////////
 // Solver Class
 /////////////////
 
 class GreedyEdgeList : public Solver {
-    struct FinishEdge {
-        FactoryKey start, end;
-        ResourceList rl;
-        double prio;
-    };
-
+    // the containers allocate from one memory resource, so a polishing
+    // iteration's mutations can live in an arena
     struct PolishSolution {
-        typedef std::map<FactoryKey, std::list<RouteKey>> SharedList;
-        typedef std::vector<RouteKey> RouteKeyTrans;
+        typedef std::pmr::map<FactoryKey, std::pmr::list<RouteKey>> SharedList;
+        typedef std::pmr::vector<RouteKey> RouteKeyTrans;
         Network net;
         Cost cost;
+        CostFunct::CostCache cost_cache; // lets splices be re-scored incrementally
         SharedList shared_facts;
         RouteKeyTrans shared2net, net2shared;
+
+        explicit PolishSolution(std::pmr::memory_resource* mem = std::pmr::get_default_resource());
+        // copy of other that allocates from mem
+        PolishSolution(const PolishSolution& other, std::pmr::memory_resource* mem);
+        PolishSolution(const PolishSolution& other) = default;
+        PolishSolution(PolishSolution&& other) = default;
+        // assigning between resources copies the containers into this one's
+        PolishSolution& operator=(const PolishSolution& other) = default;
+        PolishSolution& operator=(PolishSolution&& other) = default;
     };
     
     protected:
@@ -55,13 +64,14 @@ class GreedyEdgeList : public Solver {
         PairList<Network, Cost> history;
     
     public:
+        // networks tracked while polishing
+        static constexpr size_t DEFAULT_TRACK = 5;
+
         GreedyEdgeList(const Network& net, const CostFunct cos, const Constraints constr,
-            double d_w = 1.0, double q_w = 3.0, size_t track = 5);
+            double d_w = DEFAULT_DIST_W, double q_w = DEFAULT_QUANT_W, size_t track = DEFAULT_TRACK);
         
         // manages the creation of the edge_list
-        // O(log f)
-        void addEdge(FinishEdge fe);
-        // O(f^2 * log f)
+        // O(f^2 * log f), fewer pairs with an edge neighbourhood (see Solver)
         void generateEdgeList();
         // O(r)
         std::vector<RouteKey> getRandomRouteOrdering(const Network& net) const;
@@ -85,10 +95,12 @@ class GreedyEdgeList : public Solver {
         // O(f + r + r_f)
         void randomlySpliceRoute(PolishSolution& sltn) const;
         // O(r * (f + r + r_f)) ~ O(f^2)
+        //   the copy it splices allocates from scratch()
         PolishSolution multiSplice(const PolishSolution& net, size_t P = 2) const; 
         // polsiher
         // uses reducer/finisher functions to optimize a given network to a more optimal form
         // O(T * r^2 * (f + r + r_f)) ~ O(T * f^3)
+        //   each track splices in its own arena, reset every iteration
         Network fullyPolish(const Network& net); 
 };
 
@@ -0,0 +1,52 @@
+/*
+DistanceCache definitions
+
+Definitions for the DistanceCache class.
+*/
+
+/////////////////
+// Includes
+/////////////////
+
+#include "../../headers/data/DistanceCache.h"
+
+/////////////////
+// Constructors
+/////////////////
+
+DistanceCache::DistanceCache(const std::vector<Location>& locs, size_t max_bytes) :
+    locs_(locs)
+{
+    size_t n = locs_.size();
+    size_t pairs = n < 2 ? 0 : n * (n - 1) / 2;
+    if (pairs == 0 || pairs > max_bytes / sizeof(Dist)) {return;}
+
+    table_.resize(pairs);
+    Dist* out = table_.data();
+    for (size_t a = 1; a < n; a++)
+    {
+        for (size_t b = 0; b < a; b++)
+        {
+            *out++ = dist(locs_[a], locs_[b]);
+        }
+    }
+}
+
+/////////////////
+// Functions
+/////////////////
+
+size_t DistanceCache::size() const
+{
+    return locs_.size();
+}
+
+bool DistanceCache::isPrecomputed() const
+{
+    return !table_.empty() || locs_.size() < 2;
+}
+
+size_t DistanceCache::tableBytes() const
+{
+    return table_.size() * sizeof(Dist);
+}
@@ -11,6 +11,7 @@ Definitions for Factory class.
 /////////////////
 
 #include "../../headers/data/Factory.h"
+#include "../../headers/data/ResourceKernels.h"
 
 /////////////////
 // Functions
@@ -36,6 +37,13 @@ unallocated_(netResources)
 {
 }
 
+Factory::Factory(Location location, ResourceList netResources, ResourceList unallocated) :
+loc_(location), 
+base_quants_(netResources),
+unallocated_(unallocated) 
+{
+}
+
 // factory method
 Factory Factory::makeJunction(Location l) {
     return Factory(l);
@@ -67,61 +75,22 @@ ResourceList Factory::getAllocated() const {
 
 // Allocate and DeAllocate
 bool Factory::allocate(ResourceList rl) {
-    bool succ = true;
-    Resource r;
-    Sign base_s, rl_s;
-    for(r = static_cast<Resource>(0); r != Resource::COUNT; r++) {
-        base_s = signof(base_quants_[r]);
-        rl_s = signof(rl[r]);
-
-        // check that allocating sign (equals base sign OR zero)
-        //  AND there is enough unallocated capacity
-        if((rl_s == base_s || rl_s == ZERO_S) && abs(unallocated_[r]) >= abs(rl[r])) {
-            // allocate
-            unallocated_[r] -= rl[r]; 
-        } else {
-            // else fail
-            succ = false;
-            break;
-        }
-    }
-    if(!succ) {
-        r--;
-        while(r != Resource::COUNT) {
-            unallocated_[r] += rl[r];
-            r--;
-        }
-    }
-    return succ;
+    return allocate(base_quants_, unallocated_, rl);
 }
 bool Factory::deallocate(ResourceList rl) {
-    bool succ = true;
-    Resource r;
-    Sign base_s, rl_s;
-    ResourceList allocated = getAllocated();
-    for(r = static_cast<Resource>(0); r != Resource::COUNT; r++) {
-        base_s = signof(base_quants_[r]);
-        rl_s = signof(rl[r]);
+    return deallocate(base_quants_, unallocated_, rl);
+}
 
-        // check that allocating sign (equals zero or base sign not 0 and rl not base sign)
-        //  AND there is enough allocated capacity
-        if(((rl_s == ZERO_S) || (base_s != ZERO_S && rl_s == base_s)) && abs(allocated[r]) >= abs(rl[r])) {
-            // deallocate
-            unallocated_[r] += rl[r]; 
-        } else {
-            // else fail
-            succ = false;
-            break;
-        }
-    }
-    if(!succ) {
-        r--;
-        while(r != Resource::COUNT) {
-            unallocated_[r] -= rl[r];
-            r--;
-        }
-    }
-    return succ;
+// every resource is checked before any is changed, so a failure needs no rollback
+bool Factory::allocate(const ResourceList& base_quants, ResourceList& unallocated, const ResourceList& rl) {
+    // each allocating sign has to equal base sign OR zero
+    //  AND there has to be enough unallocated capacity
+    return ResourceKernels::allocate<ResourceList::NUM_RESOURCES>(base_quants.data(), unallocated.data(), rl.data());
+}
+bool Factory::deallocate(const ResourceList& base_quants, ResourceList& unallocated, const ResourceList& rl) {
+    // each deallocating sign has to equal zero, or base sign when base isn't 0
+    //  AND there has to be enough allocated capacity
+    return ResourceKernels::deallocate<ResourceList::NUM_RESOURCES>(base_quants.data(), unallocated.data(), rl.data());
 }
 // resets Allocated resources
 // basically just sets unallocated_ to base_quants_
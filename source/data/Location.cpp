@@ -16,6 +16,32 @@ Definitions for Location Data structure.
 #include <map>
 #define _USE_MATH_DEFINES
 
+/////////////////
+// Dist Helpers
+/////////////////
+
+// sign of a + b*sqrt(2), exactly
+// if a and b disagree, the sign is the one of whichever has the larger
+// square, a^2 against 2b^2. They can't be equal unless both are 0,
+// since sqrt(2) is irrational.
+static int signOfSqrt2Sum(int64_t a, int64_t b)
+{
+    int sa = (a > 0) - (a < 0), sb = (b > 0) - (b < 0);
+    if (sa == sb || sb == 0) {return sa;}
+    if (sa == 0) {return sb;}
+    uint64_t ua = a < 0 ? 0 - uint64_t(a) : uint64_t(a);
+    uint64_t ub = b < 0 ? 0 - uint64_t(b) : uint64_t(b);
+    // both under 2^31 (any single Dist), the squares fit in 64 bits
+    if ((ua | ub) < (uint64_t(1) << 31))
+    {
+        return ua * ua > 2 * ub * ub ? sa : sb;
+    }
+    // differences of two Dists need up to 33 bits
+    unsigned __int128 a2 = (unsigned __int128)ua * ua;
+    unsigned __int128 b2 = (unsigned __int128)ub * ub * 2;
+    return a2 > b2 ? sa : sb;
+}
+
 /////////////////
 // Dist Overloads
 /////////////////
@@ -30,7 +56,7 @@ Dist Dist::operator+=(const Dist& other) {
 Dist Dist::operator-(const Dist& other) const {
     Dist t = (Dist){rat_-other.rat_, irrat_-other.irrat_};
     // if resulting distance is negative, flip signs
-    if(t.toDouble() < 0)
+    if(signOfSqrt2Sum(t.rat_, t.irrat_) < 0)
         t = (Dist){-t.rat_, -t.irrat_};
     return t;
 }
@@ -43,14 +69,20 @@ bool Dist::operator==(const Dist& other) const {
     return rat_==other.rat_ && irrat_==other.irrat_;
 }
 
+// exact, no floating point
+int Dist::compare(const Dist& other) const
+{
+    return signOfSqrt2Sum(int64_t(rat_) - other.rat_, int64_t(irrat_) - other.irrat_);
+}
+
 bool Dist::operator>(const Dist& other) const
 {
-    return this->toDouble() > other.toDouble();
+    return compare(other) > 0;
 }
 
 bool Dist::operator<(const Dist& other) const
 {
-    return this->toDouble() < other.toDouble();
+    return compare(other) < 0;
 }
 
 bool Dist::operator>=(const Dist& other) const
@@ -104,9 +136,14 @@ bool Location::operator>=(const Location& other) const
 // Location Hash Function
 /////////////////////////
 
+// packs both coordinates and mixes them (splitmix64 finalizer),
+// so nearby Locations don't land in nearby buckets
 size_t LocationHasher::operator()(const Location& key) const noexcept
 {
-    return 17*key.x + 7919*key.y;
+    uint64_t h = (uint64_t(uint32_t(key.x)) << 32) | uint32_t(key.y);
+    h = (h ^ (h >> 30)) * 0xBF58476D1CE4E5B9ull;
+    h = (h ^ (h >> 27)) * 0x94D049BB133111EBull;
+    return h ^ (h >> 31);
 }
 
 /////////////////////////////
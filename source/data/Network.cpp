@@ -13,52 +13,253 @@ classes themselves. Network takes care of many constraints and management on its
 // Includes
 /////////////////
 #include "../../headers/data/Network.h"
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
 
+/////////////////
+// Helpers
+/////////////////
+
+// number of resources with a negative quant
+static size_t countDeficits(const ResourceList& rl)
+{
+    return __builtin_popcountll(rl.negativeMask());
+}
 
 /////////////////
 // Constructors
 /////////////////
 
-Network::Network()
+Network::Network() :
+    table_(std::make_shared<FactoryTable>()),
+    unallocated_(std::make_shared<std::vector<ResourceList>>()),
+    num_deficits_(0),
+    num_twice_(0)
 {}
 
 Network::Network(std::vector<Factory> facts) : 
-    routes_()
+    table_(std::make_shared<FactoryTable>()),
+    unallocated_(std::make_shared<std::vector<ResourceList>>()),
+    routes_(),
+    num_deficits_(0),
+    num_twice_(0)
+    {
+        for(size_t i = 0; i < facts.size(); i++)
+        {
+            addFactory(facts[i]);
+        }
+    }
+
+Network::Network(const Location* locs, const ResourceList* base_quants, size_t n) :
+    Network()
+{
+    FactoryTable& table = *table_;
+    table.locs.assign(locs, locs + n);
+    table.base_quants.assign(base_quants, base_quants + n);
+    unallocated_->assign(base_quants, base_quants + n);
+
+    // sort the ids now to check for duplicates, files are usually written sorted already
+    std::call_once(table.order->sorted, [&]() {
+        std::vector<FactoryId>& order = table.order->ids;
+        order.resize(n);
+        std::iota(order.begin(), order.end(), FactoryId(0));
+        if (!std::is_sorted(locs, locs + n))
+        {
+            std::sort(order.begin(), order.end(), 
+                [&table](FactoryId a, FactoryId b){ return table.locs[a] < table.locs[b]; });
+        }
+    });
+    const std::vector<FactoryId>& order = table.order->ids;
+    for (size_t i = 1; i < n; i++)
     {
-        for(int i = 0; i < facts.size(); i++)
+        if (table.locs[order[i-1]] == table.locs[order[i]])
         {
-            places_.insert(std::pair<FactoryKey, Factory>(facts[i].getLoc(), facts[i]));
+            throw std::invalid_argument("Network can't have two places at the same Location");
         }
     }
 
+    for (size_t i = 0; i < n; i++)
+    {
+        num_deficits_ += countDeficits(base_quants[i]);
+        if (base_quants[i] == ResourceList()) {table.num_junctions++;}
+    }
+
+    // at most half full, like addFactory leaves it
+    size_t capacity = 16;
+    while (capacity < 2*n) {capacity *= 2;}
+    rebuildIndex(table, capacity);
+}
+
 /////////////////
-// Functions
+// Factory Iterator
 /////////////////
 
-const size_t Network::getNumFactories() const
+Network::FactoryIterator::reference Network::FactoryIterator::operator*() const
+{
+    FactoryId i = id();
+    const FactoryTable& table = *net_->table_;
+    return value_type(table.locs[i], Factory(table.locs[i], table.base_quants[i], (*net_->unallocated_)[i]));
+}
+
+FactoryId Network::FactoryIterator::id() const
+{
+    return net_->placeOrder()[pos_];
+}
+
+/////////////////
+// Copy on Write
+/////////////////
+
+Network::FactoryTable& Network::editTable()
+{
+    // copy the table if another network is still using it
+    if (table_.use_count() != 1) {table_ = std::make_shared<FactoryTable>(*table_);}
+    // the places are about to change, so the old order and distances won't fit
+    table_->order = std::make_shared<OrderSlot>();
+    table_->distances = std::make_shared<DistanceSlot>();
+    return *table_;
+}
+
+std::vector<ResourceList>& Network::editUnallocated()
 {
-    size_t size = 0;
-    for (std::map<FactoryKey,Factory,LocationCompare>::const_iterator i = places_.cbegin(); i != places_.cend(); i++)
+    if (unallocated_.use_count() != 1) {unallocated_ = std::make_shared<std::vector<ResourceList>>(*unallocated_);}
+    return *unallocated_;
+}
+
+Route& Network::editRoute(RouteKey key)
+{
+    std::shared_ptr<Route>& route = routes_.at(key);
+    if (route.use_count() != 1) {route = std::make_shared<Route>(*route);}
+    return *route;
+}
+
+/////////////////
+// Factory Table
+/////////////////
+
+const FactoryId Network::NO_FACTORY;
+
+// spreads LocationHasher over an index with a power of 2 size
+static size_t indexSlot(const Location& key, size_t mask)
+{
+    return (uint64_t(LocationHasher()(key)) * 0x9E3779B97F4A7C15ull >> 32) & mask;
+}
+
+// O(1) expected
+FactoryId Network::findId(FactoryKey key) const
+{
+    const std::vector<FactoryId>& index = table_->index;
+    if (index.empty()) {return NO_FACTORY;}
+    size_t mask = index.size() - 1;
+    // linear probe until we find the key or an empty slot
+    for (size_t slot = indexSlot(key, mask); index[slot] != NO_FACTORY; slot = (slot + 1) & mask)
     {
-        if(!(i->second.getBaseQuants() == ResourceList()))
-        {
-            size++;
-        }
+        if (table_->locs[index[slot]] == key) {return index[slot];}
     }
-    return size;
+    return NO_FACTORY;
 }
 
-const size_t Network::getNumJunctions() const
+FactoryId Network::atId(FactoryKey key) const
 {
-    size_t size = 0;
-    for (std::map<FactoryKey,Factory,LocationCompare>::const_iterator i = places_.cbegin(); i != places_.cend(); i++)
+    FactoryId id = findId(key);
+    if (id == NO_FACTORY) {throw std::out_of_range("FactoryKey not in network");}
+    return id;
+}
+
+// O(f)
+void Network::rebuildIndex(FactoryTable& table, size_t capacity)
+{
+    table.index.assign(capacity, NO_FACTORY);
+    size_t mask = capacity - 1;
+    for (FactoryId id = 0; id < table.locs.size(); id++)
     {
-        if(i->second.getBaseQuants() == ResourceList())
-        {
-            size++;
-        }
+        size_t slot = indexSlot(table.locs[id], mask);
+        while (table.index[slot] != NO_FACTORY) {slot = (slot + 1) & mask;}
+        table.index[slot] = id;
+    }
+}
+
+// O(f log f) the first time for a table, O(1) after
+const std::vector<FactoryId>& Network::placeOrder() const
+{
+    OrderSlot& slot = *table_->order;
+    std::call_once(slot.sorted, [&]() {
+        const std::vector<Location>& locs = table_->locs;
+        slot.ids.resize(locs.size());
+        std::iota(slot.ids.begin(), slot.ids.end(), FactoryId(0));
+        std::sort(slot.ids.begin(), slot.ids.end(), 
+            [&locs](FactoryId a, FactoryId b){ return locs[a] < locs[b]; });
+    });
+    return slot.ids;
+}
+
+// number of stops followed by the same stop, wrapping around
+static uint32_t countTwice(const Route& route)
+{
+    const FactoryKey* keys = route.stopKeys();
+    uint32_t count = 0;
+    for (size_t i = 0; i < route.size(); i++)
+    {
+        count += keys[i] == keys[(i+1)%route.size()];
     }
-    return size;
+    return count;
+}
+
+bool Network::allocate(FactoryKey key, const ResourceList& rl)
+{
+    FactoryId id = findId(key);
+    if (id == NO_FACTORY) {return false;}
+    return allocateId(id, rl);
+}
+
+bool Network::deallocate(FactoryKey key, const ResourceList& rl)
+{
+    FactoryId id = findId(key);
+    if (id == NO_FACTORY) {return false;}
+    return deallocateId(id, rl);
+}
+
+// O(R)
+bool Network::allocateId(FactoryId id, const ResourceList& rl)
+{
+    ResourceList& unallocated = editUnallocated()[id];
+    num_deficits_ -= countDeficits(unallocated);
+    bool success = Factory::allocate(table_->base_quants[id], unallocated, rl);
+    num_deficits_ += countDeficits(unallocated);
+    return success;
+}
+
+// O(R)
+bool Network::deallocateId(FactoryId id, const ResourceList& rl)
+{
+    ResourceList& unallocated = editUnallocated()[id];
+    num_deficits_ -= countDeficits(unallocated);
+    bool success = Factory::deallocate(table_->base_quants[id], unallocated, rl);
+    num_deficits_ += countDeficits(unallocated);
+    return success;
+}
+
+// O(s)
+void Network::retallyRoute(RouteKey key)
+{
+    num_twice_ -= route_twice_[key];
+    route_twice_[key] = countTwice(*routes_[key]);
+    num_twice_ += route_twice_[key];
+}
+
+/////////////////
+// Functions
+/////////////////
+
+const size_t Network::getNumFactories() const
+{
+    return table_->locs.size() - table_->num_junctions;
+}
+
+const size_t Network::getNumJunctions() const
+{
+    return table_->num_junctions;
 }
 
 const size_t Network::getNumRoutes() const
@@ -67,58 +268,120 @@ const size_t Network::getNumRoutes() const
 }
 
 // getters for container iterators
-std::map<FactoryKey, Factory, LocationCompare>::const_iterator Network::factCBegin() const {
-    return places_.cbegin();
+Network::FactoryIterator Network::factCBegin() const {
+    return FactoryIterator(this, 0);
 }
-std::map<FactoryKey, Factory, LocationCompare>::const_iterator Network::factCEnd() const {
-    return places_.cend();
+Network::FactoryIterator Network::factCEnd() const {
+    return FactoryIterator(this, table_->locs.size());
 }
-std::vector<Route>::const_iterator Network::routeCBegin() const {
-    return routes_.cbegin();
+Network::RouteIterator Network::routeCBegin() const {
+    return RouteIterator(routes_.cbegin());
 }
-std::vector<Route>::const_iterator Network::routeCEnd() const {
-    return routes_.cend();
+Network::RouteIterator Network::routeCEnd() const {
+    return RouteIterator(routes_.cend());
 }
 
-const Factory& Network::getPlace(FactoryKey key) const
+Factory Network::getPlace(FactoryKey key) const
 {
-    //if (index >= places_.size()) {throw std::out_of_range("FactoryKey out of range");}
-    return places_.at(key);
+    FactoryId id = atId(key);
+    return Factory(table_->locs[id], table_->base_quants[id], (*unallocated_)[id]);
 }
 
 const Route& Network::getRoute(RouteKey key) const
 {
-    return routes_.at(key);
+    return *routes_.at(key);
 }
 
 bool Network::hasPlace(FactoryKey key) const
 {
-    return places_.find(key) != places_.cend();
+    return findId(key) != NO_FACTORY;
+}
+
+FactoryId Network::getPlaceId(FactoryKey key) const
+{
+    return findId(key);
+}
+
+const std::vector<FactoryId>& Network::getPlaceIds() const
+{
+    return placeOrder();
+}
+
+const Location& Network::getPlaceLoc(FactoryId id) const
+{
+    return table_->locs[id];
+}
+
+const ResourceList& Network::getPlaceBaseQuants(FactoryId id) const
+{
+    return table_->base_quants[id];
+}
+
+const ResourceList& Network::getPlaceUnallocated(FactoryId id) const
+{
+    return (*unallocated_)[id];
+}
+
+Dist Network::getPlaceDist(FactoryId a, FactoryId b) const
+{
+    return getDistances().get(a, b);
+}
+
+// O(f^2) the first time for a table, O(1) after
+const DistanceCache& Network::getDistances() const
+{
+    DistanceSlot& slot = *table_->distances;
+    std::call_once(slot.built, [&]() { slot.cache = DistanceCache(table_->locs); });
+    return slot.cache;
 }
 
 bool Network::erasePlace(FactoryKey key)
 {
-    // erasePlace must erase key from all routes, and the places_ map
-    if (places_.find(key) == places_.end()) { return false; } // check for valid key
+    // erasePlace must erase key from all routes, and the factory table
+    FactoryId id = findId(key);
+    if (id == NO_FACTORY) { return false; } // check for valid key
 
     // if the erasePlace fails, we have to undo all of the erasing that
     // we have done up till now. The easiest way is to backup the data
     // before we start eraseing it and restore it if we have to.
-    std::map<FactoryKey, Factory, LocationCompare> backupPlaces = places_;
-    std::vector<Route> backupRoutes = routes_;
-    for(int i = 0; i < getNumRoutes(); i++)
+    // Both backups share their data with this network until it is edited.
+    std::shared_ptr<std::vector<ResourceList>> backupUnallocated = unallocated_;
+    std::vector<std::shared_ptr<Route>> backupRoutes = routes_;
+    std::vector<uint32_t> backupTwice = route_twice_;
+    size_t backupNumDeficits = num_deficits_, backupNumTwice = num_twice_;
+    for(RouteKey i = 0; i < getNumRoutes(); i++)
     {
         while (getRoute(i).findStop(key) >= 0) // a place may be in a Route multiple times
         {
             if (!dropStop(i, key)) // if the drop fails, then the whole erase fails.
             {
-                places_ = backupPlaces;
+                unallocated_ = backupUnallocated;
                 routes_ = backupRoutes;
+                route_twice_ = backupTwice;
+                num_deficits_ = backupNumDeficits;
+                num_twice_ = backupNumTwice;
                 return false;
             } 
         }
     }
-    return places_.erase(key);
+
+    // remove the row by moving the last row into its place
+    FactoryTable& table = editTable();
+    std::vector<ResourceList>& unallocated = editUnallocated();
+    if (table.base_quants[id] == ResourceList()) {table.num_junctions--;}
+    num_deficits_ -= countDeficits(unallocated[id]);
+    FactoryId last = table.locs.size() - 1;
+    if (id != last)
+    {
+        table.locs[id] = table.locs[last];
+        table.base_quants[id] = table.base_quants[last];
+        unallocated[id] = unallocated[last];
+    }
+    table.locs.pop_back();
+    table.base_quants.pop_back();
+    unallocated.pop_back();
+    rebuildIndex(table, table.index.size());
+    return true;
 }
 
 bool Network::erasePlace(Factory factory)
@@ -133,59 +396,83 @@ bool Network::erasePlace(Coord x, Coord y)
 
 std::vector<FactoryKey> Network::getRouteStops(RouteKey index) const
 {
-    std::vector<FactoryKey> stops;
-    for (auto i = routes_[index].cbegin(); i != routes_[index].cend(); i++)
-    {
-        stops.push_back(i->first);
-    }
-    return stops;
+    const Route& route = *routes_[index];
+    return std::vector<FactoryKey>(route.stopKeys(), route.stopKeys() + route.size());
 }
 
 FactoryKey Network::getStop(RouteKey route, size_t stop) const
 {
     // check valid input
-    if (stop >= routes_[route].size()) {throw std::out_of_range("stop out of route range");}
-    return (routes_[route].cbegin()+stop)->first;
+    if (stop >= routes_[route]->size()) {throw std::out_of_range("stop out of route range");}
+    return (routes_[route]->cbegin()+stop)->first;
 }
 
 ResourceList Network::getStopCommand(RouteKey route, size_t stop) const{
-    return routes_.at(route).getResources(stop);
+    return routes_.at(route)->getResources(stop);
 }
 
 bool Network::addStop(RouteKey route, FactoryKey factory, size_t routePosition, ResourceList command)
 {
-    if (places_.find(factory) == places_.end()) {return false;} // check for valid input
-    if (!places_.at(factory).allocate(command)){return false;} // try to allocate the command at the factory
-    return routes_[route].addStop(factory, routePosition, command);
+    if (!hasPlace(factory)) {return false;} // check for valid input
+    if (!allocate(factory, command)){return false;} // try to allocate the command at the factory
+    bool success = editRoute(route).addStop(factory, routePosition, command);
+    retallyRoute(route);
+    return success;
 }
 
 bool Network::setStopCommand(RouteKey route, size_t stop, ResourceList newCommand)
 {
     // check for valid input
     if (routes_.size() <= route) {return false;} 
-    if (routes_.at(route).size() <= stop) {return false;} 
+    if (routes_.at(route)->size() <= stop) {return false;} 
     // store old command in case we need to reset it later
-    ResourceList oldCommand = routes_[route].getResources(stop);
-    places_.at(routes_[route][stop]).deallocate(oldCommand); // deallocate the old command
-    if (!places_.at(routes_[route][stop]).allocate(newCommand)) // try to allocate the new command
+    ResourceList oldCommand = routes_[route]->getResources(stop);
+    FactoryId id = atId(getStop(route, stop));
+    deallocateId(id, oldCommand); // deallocate the old command
+    if (!allocateId(id, newCommand)) // try to allocate the new command
     {
         // if the newCommand fails to allocate, restore the system to the old command.
-        places_.at(routes_[route][stop]).allocate(oldCommand);
+        allocateId(id, oldCommand);
         return false;
     }
     // finally, set the newCommand in the Route
-    routes_[route].setResourceList(stop, newCommand);
+    editRoute(route).setResourceList(stop, newCommand);
     return true;
 }
 
 bool Network::dropStop(RouteKey routeKey, FactoryKey factoryKey, int past)
 {
-    return routes_[routeKey].dropStop(factoryKey, past);
+    bool success = editRoute(routeKey).dropStop(factoryKey, past);
+    retallyRoute(routeKey);
+    return success;
 }
 
+// O(1) expected, the Location order is sorted the next time it is used
 void Network::addFactory(Factory factory)
 {
-    places_.insert(std::pair<FactoryKey,Factory>(factory.getLoc(), factory));
+    // an existing place is left untouched
+    Location loc = factory.getLoc();
+    if (hasPlace(loc)) {return;}
+
+    FactoryTable& table = editTable();
+    FactoryId id = table.locs.size();
+    table.locs.push_back(loc);
+    table.base_quants.push_back(factory.getBaseQuants());
+    editUnallocated().push_back(factory.getUnallocated());
+    num_deficits_ += countDeficits(factory.getUnallocated());
+    if (table.base_quants.back() == ResourceList()) {table.num_junctions++;}
+
+    // keep the index at most half full
+    if (2*table.locs.size() > table.index.size())
+    {
+        rebuildIndex(table, std::max<size_t>(16, 2*table.index.size()));
+    }
+    else
+    {
+        size_t mask = table.index.size() - 1, slot = indexSlot(loc, mask);
+        while (table.index[slot] != NO_FACTORY) {slot = (slot + 1) & mask;}
+        table.index[slot] = id;
+    }
 }
 
 void Network::addFactory(Location loc, ResourceList production)
@@ -208,7 +495,7 @@ bool Network::eraseFactory(Factory factory)
 
 bool Network::eraseFactory(FactoryKey key)
 {
-    if (places_.find(key) == places_.end()) {return false;} // if the key is not found, the erase fails and returns
+    if (!hasPlace(key)) {return false;} // if the key is not found, the erase fails and returns
     return eraseFactory(getPlace(key));
 }
 
@@ -235,7 +522,7 @@ bool Network::eraseJunction(Factory junciton)
 
 bool Network::eraseJunction(FactoryKey key)
 {
-    if (places_.find(key) == places_.end()) {return false;} // if the key is not found, the erase fails and returns
+    if (!hasPlace(key)) {return false;} // if the key is not found, the erase fails and returns
     return eraseJunction(getPlace(key));
 }
 
@@ -244,12 +531,9 @@ bool Network::addRoute(std::vector<FactoryKey> initialFactories, std::vector<Res
     PairList<FactoryKey,ResourceList> pairs;
     if (initialCommands.size() < initialFactories.size()) // if there are not enough initial commands, add blank ResourceLists
     {
-        for (int i = 0; i < initialFactories.size() - initialCommands.size(); i++) 
-        {
-            initialCommands.push_back(ResourceList());
-        }
+        initialCommands.resize(initialFactories.size());
     }
-    for (int i = 0; i < initialFactories.size(); i++)
+    for (size_t i = 0; i < initialFactories.size(); i++)
     {
         pairs.push_back(std::pair<FactoryKey, ResourceList>(initialFactories[i], initialCommands[i]));
     }
@@ -275,19 +559,21 @@ bool Network::addRoute(PairList<FactoryKey, ResourceList> initialPairs)
 
 bool Network::addRoute(Route route){
     // by the time we have created a route, it will have at least two stops.
-    for (int i = 0; i < route.size(); i++)
+    for (size_t i = 0; i < route.size(); i++)
     {
-        if (!places_[route[i]].allocate(route.getResources(i))) // check that the Command can be executed
+        if (!allocate(route[i], route.getResources(i))) // check that the place exists and the Command can be executed
         { // if it can't, we have to reset the network to the state it was in before we tried to add this
           // route, by deallocating all allocated resources up till now.
-            for (int ii = 0; ii < i; ii++) // aye aye aye!
+            for (size_t ii = 0; ii < i; ii++) // aye aye aye!
             {
-                places_[route[ii]].deallocate(route.getResources(ii));
+                deallocate(route[ii], route.getResources(ii));
             }
             return false; // addRoute fails
         }
     }
-    routes_.push_back(route);
+    routes_.push_back(std::make_shared<Route>(std::move(route)));
+    route_twice_.push_back(countTwice(*routes_.back()));
+    num_twice_ += route_twice_.back();
     return true; // addRoute Success
 }
 
@@ -295,8 +581,8 @@ bool Network::eraseRoute(Route route)
 {
     //Finds route and deletes it from vector
     //Returning true inside the for loop assumes that the route is unique otherwise it will only delete the first one
-    for(int i = 0; i < routes_.size(); i++){
-        if(routes_[i] == route) { return eraseRoute(i); }
+    for(RouteKey i = 0; i < routes_.size(); i++){
+        if(*routes_[i] == route) { return eraseRoute(i); }
     }
     //Return false if didn't delete anything
     return false;
@@ -307,13 +593,16 @@ bool Network::eraseRoute(RouteKey key)
     // check for valid input
     if (key >= routes_.size()) {return false;}
     // iterate over the route, and deallocate the resources at each stop
-    for(int i = 0; i < routes_[key].size(); i++)
+    // the route itself is about to be erased, so there is no need to clear its commands
+    const Route& route = *routes_[key];
+    for(size_t i = 0; i < route.size(); i++)
     {
-        places_[routes_[key][i]].deallocate(routes_[key].getResources(i)); // should not fail
-        routes_[key].setResourceList(i, ResourceList()); // set the command to empty
+        deallocate((route.cbegin()+i)->first, route.getResources(i)); // should not fail
     }
     // finally, erase the route
     routes_.erase(routes_.begin()+key);
+    num_twice_ -= route_twice_[key];
+    route_twice_.erase(route_twice_.begin()+key);
     return true;
 }
 
@@ -324,11 +613,11 @@ void Network::eraseAllRoutes() {
 
 void Network::reverseRoute(RouteKey key) {
     // no checks, cuz allocations aren't changing
-    routes_.at(key).reverse();
+    editRoute(key).reverse();
 }
 void Network::rotateRoute(RouteKey key, size_t n) {
     // no checks, cuz allocations aren't changing
-    routes_.at(key).rotate(n);
+    editRoute(key).rotate(n);
 }
 /*bool Network::combineRoutes(RouteKey k1, RouteKey k2, size_t i1, size_t i2) {
     // can only combine on matching stop
@@ -341,28 +630,38 @@ void Network::rotateRoute(RouteKey key, size_t n) {
     return true;
 }*/
 
+size_t Network::getNumDeficits() const
+{
+    return num_deficits_;
+}
+
+size_t Network::getNumTwiceViolations() const
+{
+    return num_twice_;
+}
+
 std::vector<FactoryKey> Network::getDeficit(Resource resource) const
 {
     std::vector<FactoryKey> hasDeficit;
     if (resource != Resource::COUNT)
     {
-        for (auto i = places_.cbegin(); i != places_.cend(); i++)
+        for (FactoryId id : placeOrder())
         {
-            if (i->second.getUnallocated()[resource] < 0)
+            if ((*unallocated_)[id][resource] < 0)
             {
-                hasDeficit.push_back(i->first);
+                hasDeficit.push_back(table_->locs[id]);
             }
         }
     }
     else
     {
-        for (auto i = places_.cbegin(); i != places_.cend(); i++)
+        for (FactoryId id : placeOrder())
         {
             for(Resource r = Resource(0); r != Resource::COUNT; r++)
             {
-                if (i->second.getUnallocated()[r] < 0)
+                if ((*unallocated_)[id][r] < 0)
                 {
-                    hasDeficit.push_back(i->first);
+                    hasDeficit.push_back(table_->locs[id]);
                     break;
                 }
             }
@@ -376,27 +675,27 @@ std::vector<FactoryKey> Network::getSurplus(Resource resource) const
         std::vector<FactoryKey> hasSurplus;
     if (resource != Resource::COUNT)
     {
-        for (auto i = places_.cbegin(); i != places_.cend(); i++)
+        for (FactoryId id : placeOrder())
         {
-            if (i->second.getUnallocated()[resource] > 0)
+            if ((*unallocated_)[id][resource] > 0)
             {
-                hasSurplus.push_back(i->first);
+                hasSurplus.push_back(table_->locs[id]);
             }
         }
     }
     else
     {
-        for (auto i = places_.cbegin(); i != places_.cend(); i++)
+        for (FactoryId id : placeOrder())
         {
             for(Resource r = Resource(0); r != Resource::COUNT; r++)
             {
-                if (i->second.getUnallocated()[r] > 0)
+                if ((*unallocated_)[id][r] > 0)
                 {
-                    hasSurplus.push_back(i->first);
+                    hasSurplus.push_back(table_->locs[id]);
                     break;
                 }
             }
         }
     }
     return hasSurplus;
-}
+}
\ No newline at end of file
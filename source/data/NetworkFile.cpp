@@ -0,0 +1,302 @@
+/*
+NetworkFile definitions
+
+Definitions for writeNetworkFile and the MappedNetworkFile class.
+Files are mapped with mmap on POSIX systems and read into a buffer
+elsewhere.
+*/
+
+/////////////////
+// Includes
+/////////////////
+
+#include "../../headers/data/NetworkFile.h"
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define NETWORK_FILE_MMAP
+#endif
+
+// the arrays are copied to and from the file byte for byte
+static_assert(std::is_trivially_copyable<Location>::value && sizeof(Location) == 2 * sizeof(Coord),
+    "Locations are stored as they are in memory");
+static_assert(std::is_trivially_copyable<ResourceList>::value && sizeof(ResourceList) == Resource::COUNT * sizeof(Quant),
+    "ResourceLists are stored as they are in memory");
+#if defined(__BYTE_ORDER__)
+static_assert(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__, "network files are little endian");
+#endif
+
+/////////////////
+// Helpers
+/////////////////
+
+// next multiple of NetworkFile::ALIGNMENT
+static uint64_t aligned(uint64_t offset)
+{
+    return (offset + NetworkFile::ALIGNMENT - 1) / NetworkFile::ALIGNMENT * NetworkFile::ALIGNMENT;
+}
+
+// writes bytes at offset, padding from the current end of the file
+static void writeAt(std::ofstream& out, uint64_t offset, const void* bytes, size_t size)
+{
+    static const char padding[NetworkFile::ALIGNMENT] = {};
+    uint64_t at = out.tellp();
+    out.write(padding, offset - at);
+    out.write(static_cast<const char*>(bytes), size);
+}
+
+// true if count elements of size bytes at offset fit in a file of file_size bytes
+static bool fits(uint64_t offset, uint64_t count, uint64_t size, uint64_t file_size)
+{
+    return offset % NetworkFile::ALIGNMENT == 0 && offset <= file_size
+        && count <= (file_size - offset) / size;
+}
+
+/////////////////
+// Writing
+/////////////////
+
+// O(f + s)
+void writeNetworkFile(const Network& net, const std::string& path)
+{
+    // gather the places in Location order, so loading doesn't need to sort them
+    const std::vector<FactoryId>& ids = net.getPlaceIds();
+    std::vector<Location> locs;
+    std::vector<ResourceList> quants;
+    locs.reserve(ids.size());
+    quants.reserve(ids.size());
+    for (FactoryId id : ids)
+    {
+        locs.push_back(net.getPlaceLoc(id));
+        quants.push_back(net.getPlaceBaseQuants(id));
+    }
+
+    std::vector<uint64_t> starts(1, 0);
+    for (auto it = net.routeCBegin(); it != net.routeCEnd(); ++it)
+    {
+        starts.push_back(starts.back() + it->size());
+    }
+
+    NetworkFileHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, NetworkFile::MAGIC, sizeof(header.magic));
+    header.version = NetworkFile::VERSION;
+    header.num_resources = Resource::COUNT;
+    header.num_places = locs.size();
+    header.num_routes = net.getNumRoutes();
+    header.num_stops = starts.back();
+    header.place_locs_offset = aligned(sizeof(header));
+    header.place_quants_offset = aligned(header.place_locs_offset + header.num_places * sizeof(Location));
+    header.route_starts_offset = aligned(header.place_quants_offset + header.num_places * sizeof(ResourceList));
+    header.stop_keys_offset = aligned(header.route_starts_offset + starts.size() * sizeof(uint64_t));
+    header.stop_commands_offset = aligned(header.stop_keys_offset + header.num_stops * sizeof(Location));
+    header.file_size = header.stop_commands_offset + header.num_stops * sizeof(ResourceList);
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) {throw std::runtime_error("can't open network file for writing: " + path);}
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    writeAt(out, header.place_locs_offset, locs.data(), locs.size() * sizeof(Location));
+    writeAt(out, header.place_quants_offset, quants.data(), quants.size() * sizeof(ResourceList));
+    writeAt(out, header.route_starts_offset, starts.data(), starts.size() * sizeof(uint64_t));
+
+    // the stops go straight from each route's arrays
+    writeAt(out, header.stop_keys_offset, nullptr, 0);
+    for (auto it = net.routeCBegin(); it != net.routeCEnd(); ++it)
+    {
+        out.write(reinterpret_cast<const char*>(it->stopKeys()), it->size() * sizeof(Location));
+    }
+    writeAt(out, header.stop_commands_offset, nullptr, 0);
+    for (auto it = net.routeCBegin(); it != net.routeCEnd(); ++it)
+    {
+        out.write(reinterpret_cast<const char*>(it->stopCommands()), it->size() * sizeof(ResourceList));
+    }
+
+    out.close();
+    if (!out) {throw std::runtime_error("can't write network file: " + path);}
+}
+
+/////////////////
+// Constructors
+/////////////////
+
+MappedNetworkFile::MappedNetworkFile(const std::string& path) :
+    data_(nullptr),
+    size_(0),
+    mapped_(false),
+    header_(nullptr),
+    route_starts_(nullptr)
+{
+#ifdef NETWORK_FILE_MMAP
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {throw std::runtime_error("can't open network file: " + path);}
+    struct stat st;
+    if (::fstat(fd, &st) != 0)
+    {
+        ::close(fd);
+        throw std::runtime_error("can't read network file: " + path);
+    }
+    size_ = st.st_size;
+    if (size_ > 0)
+    {
+        void* data = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data == MAP_FAILED)
+        {
+            ::close(fd);
+            throw std::runtime_error("can't map network file: " + path);
+        }
+        data_ = static_cast<const char*>(data);
+        mapped_ = true;
+    }
+    ::close(fd); // the mapping stays valid without the descriptor
+#else
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {throw std::runtime_error("can't open network file: " + path);}
+    buffer_.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    if (in.bad()) {throw std::runtime_error("can't read network file: " + path);}
+    data_ = buffer_.data();
+    size_ = buffer_.size();
+#endif
+
+    try
+    {
+        validate();
+    }
+    catch (...)
+    {
+        release();
+        throw;
+    }
+}
+
+MappedNetworkFile::~MappedNetworkFile()
+{
+    release();
+}
+
+/////////////////
+// Functions
+/////////////////
+
+void MappedNetworkFile::release()
+{
+#ifdef NETWORK_FILE_MMAP
+    if (mapped_) {::munmap(const_cast<char*>(data_), size_);}
+#endif
+    mapped_ = false;
+    data_ = nullptr;
+    size_ = 0;
+    buffer_.clear();
+}
+
+void MappedNetworkFile::validate()
+{
+    if (size_ < sizeof(NetworkFileHeader)) {throw std::invalid_argument("network file is too short");}
+    header_ = reinterpret_cast<const NetworkFileHeader*>(data_);
+    const NetworkFileHeader& h = *header_;
+    if (std::memcmp(h.magic, NetworkFile::MAGIC, sizeof(h.magic)) != 0)
+    {
+        throw std::invalid_argument("not a network file");
+    }
+    if (h.version != NetworkFile::VERSION) {throw std::invalid_argument("unsupported network file version");}
+    if (h.num_resources != Resource::COUNT)
+    {
+        throw std::invalid_argument("network file has a different number of resources");
+    }
+    if (h.file_size != size_) {throw std::invalid_argument("network file is truncated");}
+    if (h.num_routes >= size_ / sizeof(uint64_t)
+        || !fits(h.place_locs_offset, h.num_places, sizeof(Location), size_)
+        || !fits(h.place_quants_offset, h.num_places, sizeof(ResourceList), size_)
+        || !fits(h.route_starts_offset, h.num_routes + 1, sizeof(uint64_t), size_)
+        || !fits(h.stop_keys_offset, h.num_stops, sizeof(Location), size_)
+        || !fits(h.stop_commands_offset, h.num_stops, sizeof(ResourceList), size_))
+    {
+        throw std::invalid_argument("network file arrays don't fit in the file");
+    }
+
+    // every route needs two stops, and together they must cover the stops exactly
+    route_starts_ = reinterpret_cast<const uint64_t*>(data_ + h.route_starts_offset);
+    if (route_starts_[0] != 0 || route_starts_[h.num_routes] != h.num_stops)
+    {
+        throw std::invalid_argument("network file routes don't match its stops");
+    }
+    for (uint64_t r = 0; r < h.num_routes; r++)
+    {
+        if (route_starts_[r + 1] < route_starts_[r] || route_starts_[r + 1] - route_starts_[r] < 2)
+        {
+            throw std::invalid_argument("network file has a route with less than 2 stops");
+        }
+    }
+}
+
+size_t MappedNetworkFile::getNumPlaces() const
+{
+    return header_->num_places;
+}
+
+const Location* MappedNetworkFile::getPlaceLocs() const
+{
+    return reinterpret_cast<const Location*>(data_ + header_->place_locs_offset);
+}
+
+const ResourceList* MappedNetworkFile::getPlaceBaseQuants() const
+{
+    return reinterpret_cast<const ResourceList*>(data_ + header_->place_quants_offset);
+}
+
+size_t MappedNetworkFile::getNumRoutes() const
+{
+    return header_->num_routes;
+}
+
+size_t MappedNetworkFile::getRouteSize(RouteKey route) const
+{
+    if (route >= header_->num_routes) {throw std::out_of_range("RouteKey not in network file");}
+    return route_starts_[route + 1] - route_starts_[route];
+}
+
+const Location* MappedNetworkFile::getRouteStops(RouteKey route) const
+{
+    if (route >= header_->num_routes) {throw std::out_of_range("RouteKey not in network file");}
+    return reinterpret_cast<const Location*>(data_ + header_->stop_keys_offset) + route_starts_[route];
+}
+
+const ResourceList* MappedNetworkFile::getRouteCommands(RouteKey route) const
+{
+    if (route >= header_->num_routes) {throw std::out_of_range("RouteKey not in network file");}
+    return reinterpret_cast<const ResourceList*>(data_ + header_->stop_commands_offset) + route_starts_[route];
+}
+
+Network MappedNetworkFile::toNetwork() const
+{
+    Network net(getPlaceLocs(), getPlaceBaseQuants(), getNumPlaces());
+    for (RouteKey r = 0; r < getNumRoutes(); r++)
+    {
+        const Location* stops = getRouteStops(r);
+        const ResourceList* commands = getRouteCommands(r);
+        size_t n = getRouteSize(r);
+        if (!net.addRoute(std::vector<FactoryKey>(stops, stops + n), std::vector<ResourceList>(commands, commands + n)))
+        {
+            throw std::invalid_argument("network file has a route its places can't supply");
+        }
+    }
+    return net;
+}
+
+Network readNetworkFile(const std::string& path)
+{
+    return MappedNetworkFile(path).toNetwork();
+}
+
+bool isNetworkFile(const std::string& path)
+{
+    char magic[sizeof(NetworkFile::MAGIC)];
+    std::ifstream in(path, std::ios::binary);
+    return in.read(magic, sizeof(magic)) && std::memcmp(magic, NetworkFile::MAGIC, sizeof(magic)) == 0;
+}
@@ -11,6 +11,11 @@ Definitions for ResourcesLists
 /////////////////
 
 #include "../../headers/data/ResourceList.h"
+#include "../../headers/data/ResourceKernels.h"
+#include <array>
+#include <cctype>
+#include <stdexcept>
+#include <string>
 
 /////////////////
 // Resource Functions
@@ -46,116 +51,185 @@ Resource operator--(Resource& r, int) {
     return orig;
 }
 
+static const char* const NAMED_RESOURCES[Resource::NUM_NAMED_RESOURCES] = {
+    "Copper", "Steel", "Iron", "Stone", "Uranium", "Circuits", 
+    "Fish", "Wood", "NuclearFuel", "Wire", "Engine", "Gear"
+};
+
+// names of the whole catalogue, built once
+static const std::array<std::string, Resource::COUNT>& resourceNames() {
+    static const std::array<std::string, Resource::COUNT> names = []() {
+        std::array<std::string, Resource::COUNT> out;
+        for(int i = 0; i < Resource::COUNT; i++)
+            out[i] = i < Resource::NUM_NAMED_RESOURCES ? NAMED_RESOURCES[i] : "Resource" + std::to_string(i);
+        return out;
+    }();
+    return names;
+}
+
+const char* resourceName(Resource r) {
+    if(r < 0 || r >= Resource::COUNT) {
+        throw std::out_of_range("Resource has no name");
+    }
+    return resourceNames()[r].c_str();
+}
+
+// O(COUNT * name length)
+bool parseResource(std::string_view name, Resource& r) {
+    for(int i = 0; i < Resource::COUNT; i++) {
+        if(sameName(name, resourceNames()[i])) {
+            r = Resource(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+// O(a + b)
+bool sameName(std::string_view a, std::string_view b) {
+    auto separator = [](char c){ return c == '_' || c == '-' || c == ' '; };
+    size_t i = 0, j = 0;
+    while(true) {
+        while(i < a.size() && separator(a[i])) {i++;}
+        while(j < b.size() && separator(b[j])) {j++;}
+        if(i == a.size() || j == b.size()) {return i == a.size() && j == b.size();}
+        if(std::tolower(static_cast<unsigned char>(a[i++])) != std::tolower(static_cast<unsigned char>(b[j++]))) {return false;}
+    }
+}
+
 ///////////////////////////////////////////////////////////////////////////////
-// ResourceList Functions
+// BasicResourceList Functions
 ///////////////////////////////////////////////////////////////////////////////
 
-ResourceList::ResourceList() {
-    for(ResourceList::iterator i = begin(); i != end(); i++)
-        *i = 0;
+template <size_t N>
+BasicResourceList<N>::BasicResourceList() {
+    this->fill(0);
 }
 // assign resource list from a map, which can be created with an initializer_list
-ResourceList::ResourceList(std::map<Resource, Quant> rs) {
-    for(int i = 0; Resource(i) != Resource::COUNT; i++ ) {
-        operator[](i) = rs.find(Resource(i))->second;
+template <size_t N>
+BasicResourceList<N>::BasicResourceList(std::map<Resource, Quant> rs) {
+    this->fill(0);
+    for(const std::pair<const Resource, Quant>& r : rs) {
+        if(r.first < 0 || size_t(r.first) >= N) {throw std::out_of_range("Resource is not in this ResourceList");}
+        this->operator[](r.first) = r.second;
     }
 }
 
-bool ResourceList::isEmpty() const {
-    for(ResourceList::const_iterator i = begin(); i != end(); i++)
-        if(*i != 0)
-            return false;
-    return true;
+template <size_t N>
+bool BasicResourceList<N>::isEmpty() const {
+    return (negativeMask() | positiveMask()) == 0;
 }
 
-ResourceList ResourceList::operator+(const ResourceList& rl) const {
-    ResourceList sum;
-    for(Resource r = Resource(0); r != Resource::COUNT; r++)
-        sum[r] = operator[](r) + rl[r];
+template <size_t N>
+BasicResourceList<N> BasicResourceList<N>::operator+(const BasicResourceList& rl) const {
+    BasicResourceList sum;
+    ResourceKernels::add<N>(this->data(), rl.data(), sum.data());
     return sum;
 }
 
-ResourceList ResourceList::operator-(const ResourceList& rl) const {
-    ResourceList difference;
-    for(Resource r = Resource(0); r != Resource::COUNT; r++)
-        difference[r] = operator[](r) - rl[r];
+template <size_t N>
+BasicResourceList<N> BasicResourceList<N>::operator-(const BasicResourceList& rl) const {
+    BasicResourceList difference;
+    ResourceKernels::sub<N>(this->data(), rl.data(), difference.data());
     return difference;
 }
 
-ResourceList& ResourceList::operator+=(const ResourceList& other)
+template <size_t N>
+BasicResourceList<N>& BasicResourceList<N>::operator+=(const BasicResourceList& other)
 {
-    *this = *this + other;
+    ResourceKernels::add<N>(this->data(), other.data(), this->data());
     return *this;
 }
 
-ResourceList& ResourceList::operator-=(const ResourceList& other)
+template <size_t N>
+BasicResourceList<N>& BasicResourceList<N>::operator-=(const BasicResourceList& other)
 {
-    *this = *this - other;
+    ResourceKernels::sub<N>(this->data(), other.data(), this->data());
     return *this;
 }
 
-bool ResourceList::allPositive() const
+template <size_t N>
+bool BasicResourceList<N>::allPositive() const
 {
-    for (ResourceList::const_iterator i = cbegin(); i != end(); i++)
-    {
-        if (*i < 0)
-        {
-            return false;
-        }
-    }
-    return true;
+    return negativeMask() == 0;
+}
+
+template <size_t N>
+uint64_t BasicResourceList<N>::negativeMask() const
+{
+    return ResourceKernels::negativeMask<N>(this->data());
+}
+
+template <size_t N>
+uint64_t BasicResourceList<N>::positiveMask() const
+{
+    return ResourceKernels::positiveMask<N>(this->data());
+}
+
+template <size_t N>
+Quant BasicResourceList<N>::total() const
+{
+    return ResourceKernels::sum<N>(this->data());
+}
+
+template <size_t N>
+void BasicResourceList<N>::clampNegative()
+{
+    ResourceKernels::clampNegative<N>(this->data());
 }
 
-std::list<Resource> ResourceList::getNegative() const
+template <size_t N>
+std::list<Resource> BasicResourceList<N>::getNegative() const
 {
     std::list<Resource> negatives;
-    for (Resource r = Resource(0); r != Resource::COUNT; r++)
+    for (uint64_t mask = negativeMask(); mask; mask &= mask - 1)
     {
-        if (operator[](r) < 0)
-        {
-            negatives.push_back(r);
-        }
+        negatives.push_back(Resource(__builtin_ctzll(mask)));
     }
     return negatives;
 }
 
-std::list<Resource> ResourceList::getPositive() const
+template <size_t N>
+std::list<Resource> BasicResourceList<N>::getPositive() const
 {
     std::list<Resource> positives;
-    for (Resource r = Resource(0); r != Resource::COUNT; r++)
+    for (uint64_t mask = positiveMask(); mask; mask &= mask - 1)
     {
-        if (operator[](r) > 0)
-        {
-            positives.push_back(r);
-        }
+        positives.push_back(Resource(__builtin_ctzll(mask)));
     }
     return positives;
 }
 // get a RL of the resources are that are negative in this list
 //   all other Quants set to 0
-ResourceList ResourceList::getNegativeList() const {
-    ResourceList neg_rl;
-    for(const Resource& r : getNegative())
-        neg_rl[r] = operator[](r);
+template <size_t N>
+BasicResourceList<N> BasicResourceList<N>::getNegativeList() const {
+    BasicResourceList neg_rl;
+    for(uint64_t mask = negativeMask(); mask; mask &= mask - 1) {
+        int r = __builtin_ctzll(mask);
+        neg_rl[r] = this->operator[](r);
+    }
     return neg_rl;
 }
 // get a RL of the resources are that are positive in this list
 //   all other Quants set to 0
-ResourceList ResourceList::getPositiveList() const {
-    ResourceList post_rl;
-    for(const Resource& r : getPositive())
-        post_rl[r] = operator[](r);
+template <size_t N>
+BasicResourceList<N> BasicResourceList<N>::getPositiveList() const {
+    BasicResourceList post_rl;
+    for(uint64_t mask = positiveMask(); mask; mask &= mask - 1) {
+        int r = __builtin_ctzll(mask);
+        post_rl[r] = this->operator[](r);
+    }
     return post_rl;
 }
 
-bool ResourceList::operator==(const ResourceList& other) const
+template <size_t N>
+bool BasicResourceList<N>::operator==(const BasicResourceList& other) const
 {
-    for(int i = 0; i < size(); i++)
-    {
-        if(operator[](i) != other[i])
-        {
-            return false;
-        }
-    }
-    return true;
-}
\ No newline at end of file
+    return ResourceKernels::equal<N>(this->data(), other.data());
+}
+
+/////////////////
+// Instantiations
+/////////////////
+
+template class BasicResourceList<Resource::COUNT>;
@@ -14,58 +14,115 @@ Definitions for Route data structure
 #include "../../headers/data/Route.h"
 #include <exception>
 #include <algorithm>
+#include <thread>
 
 /////////////////
 // Constructor
 /////////////////
 
 Route::Route(PairList<FactoryKey, ResourceList> init_facts) :
-stops_(init_facts)
+metrics_state_(STALE)
 {
     // check for enough facts
     if(init_facts.size() < 2)
         throw std::invalid_argument("Route must be initialized with at least 2 factories");
+    keys_.reserve(init_facts.size());
+    commands_.reserve(init_facts.size());
+    for(const std::pair<FactoryKey, ResourceList>& stop : init_facts)
+        addStop(stop.first, stop.second);
 }
 
-Route::Route(FactoryKey from, FactoryKey to, ResourceList fromResourceList, ResourceList toResourceList)
+Route::Route(FactoryKey from, FactoryKey to, ResourceList fromResourceList, ResourceList toResourceList) :
+metrics_state_(STALE)
 {
     addStop(from, fromResourceList);
     addStop(to, toResourceList);
 }
 
+// copies keep the other route's metrics if they are ready
+Route::Route(const Route& other) :
+keys_(other.keys_),
+commands_(other.commands_),
+metrics_state_(STALE)
+{
+    if(other.metrics_state_.load(std::memory_order_acquire) == READY) {
+        metrics_ = other.metrics_;
+        metrics_state_ = READY;
+    }
+}
+
+Route::Route(Route&& other) :
+keys_(std::move(other.keys_)),
+commands_(std::move(other.commands_)),
+metrics_(other.metrics_),
+metrics_state_(other.metrics_state_.load())
+{
+    other.invalidate();
+}
+
+Route& Route::operator=(const Route& other) {
+    if(this != &other) {
+        keys_ = other.keys_;
+        commands_ = other.commands_;
+        metrics_state_ = STALE;
+        if(other.metrics_state_.load(std::memory_order_acquire) == READY) {
+            metrics_ = other.metrics_;
+            metrics_state_ = READY;
+        }
+    }
+    return *this;
+}
+
+Route& Route::operator=(Route&& other) {
+    if(this != &other) {
+        keys_ = std::move(other.keys_);
+        commands_ = std::move(other.commands_);
+        metrics_ = other.metrics_;
+        metrics_state_ = other.metrics_state_.load();
+        other.invalidate();
+    }
+    return *this;
+}
+
 /////////////////
 // Functions
 /////////////////
-// const_iterator getters for the internal container of stops
-//   iterator dereferences to std::pair<FactoryKey, ResourceList>
+// const_iterator getters for the stops
+//   iterator dereferences to std::pair<const FactoryKey&, const ResourceList&>
 //   so cbegin()->first gets key of first factory
-//   and cend()-second gets RL of first factory
-PairList<FactoryKey, ResourceList>::const_iterator Route::cbegin() const {
-    return stops_.cbegin();
+//   and cbegin()->second gets RL of first factory
+Route::const_iterator Route::cbegin() const {
+    return const_iterator(keys_.data(), commands_.data(), 0);
+}
+Route::const_iterator Route::cend() const {
+    return const_iterator(keys_.data(), commands_.data(), size());
+}
+
+const FactoryKey* Route::stopKeys() const {
+    return keys_.data();
 }
-PairList<FactoryKey, ResourceList>::const_iterator Route::cend() const {
-    return stops_.cend();
+const ResourceList* Route::stopCommands() const {
+    return commands_.data();
 }
 
 bool Route::addStop(FactoryKey factoryIndex, ResourceList allocated) 
 {
-    stops_.push_back(std::pair<FactoryKey, ResourceList>(factoryIndex, allocated));
+    keys_.push_back(factoryIndex);
+    commands_.push_back(allocated);
+    invalidate();
     return true;
 }
 
 bool Route::addStop(FactoryKey factoryIndex, size_t index, ResourceList allocated) 
 {
-    if (index >= stops_.size()) // if the index is out of range, we will just add the stop to the end
+    if (index >= size()) // if the index is out of range, we will just add the stop to the end
     {
         //throw(std::out_of_range("Tried to add stop outside of route range"));
         return addStop(factoryIndex, allocated);
     }
-    PairList<FactoryKey, ResourceList>::iterator position = stops_.begin();
-    for (int i = 0; i < index; i++)
-    {
-        position++;
-    }
-    stops_.insert(position, std::pair<FactoryKey, ResourceList>(factoryIndex, allocated));
+    keys_.insert(index, factoryIndex);
+    commands_.insert(index, allocated);
+    invalidate();
     return true;
 }
 
@@ -78,29 +135,21 @@ bool Route::dropStop(FactoryKey factoryIndex, int past)
     if(!(size() > 2)) {return false;} // enforce that a route cannot have less than two stops.
     if(past >= size()) {throw std::out_of_range("Attempted to drop factoryIndex outside of Route range");} // check for valid input
 
-    PairList<FactoryKey, ResourceList>::iterator position = stops_.begin();
-    for (int i = 0; i < past; i++)
-    {
-        position++;
-    }
-    while (position != stops_.end())
-    {
-        if (position->first == factoryIndex)
-        {
-            stops_.erase(position);
-            return true;
-        }
-        position++;
-    }
-    return false;
+    const FactoryKey* position = std::find(keys_.begin() + past, keys_.end(), factoryIndex);
+    if (position == keys_.end()) {return false;}
+    size_t stop = position - keys_.begin();
+    keys_.erase(stop);
+    commands_.erase(stop);
+    invalidate();
+    return true;
 }
 
 // add up resources dropped off and picked up all stops to get net resourcelist
 // to fit constraints, the resulting RL should have no negative quants
 ResourceList Route::getNetResources() const {
     ResourceList rl;
-    for(int i = 0; i < stops_.size(); i++) {
-        rl += getResources(i);
+    for(const ResourceList& command : commands_) {
+        rl += command;
     }
     return rl;
 }
@@ -108,13 +157,13 @@ ResourceList Route::getNetResources() const {
 const ResourceList Route::getResources(size_t stop) const
 {
     if(stop >= size()) {throw std::out_of_range("Attempted to getResources outside of Route range");} // check for valid input
-    return stops_[stop].second;
+    return commands_[stop];
 }
 
 const Quant Route::getResourceAmount(size_t stop, Resource resource) const
 {
     if(stop >= size()) {throw std::out_of_range("Attempted to getResourcesAmount outside of Route range");} // check for valid input
-    return stops_[stop].second[resource];
+    return commands_[stop][resource];
 }
 
 FactoryKey& Route::operator[](size_t stop)
@@ -123,90 +172,136 @@ FactoryKey& Route::operator[](size_t stop)
     {
         throw std::out_of_range("Route stop out of range");
     }
-    return stops_[stop].first;
+    invalidate();
+    return keys_[stop];
 }
 
 size_t Route::size() const { 
-    return stops_.size();
+    return keys_.size();
 }
 
 const bool Route::operator==(const Route& other) const
 {
     if (size() != other.size()) {return false;}
-    for (int i = 0; i < size(); i++)
-    {
-        if (stops_[i] != other.stops_[i] or getResources(i) != other.getResources(i)) {return false;}
-    }
-    return true;
+    return std::equal(keys_.begin(), keys_.end(), other.keys_.begin()) &&
+           std::equal(commands_.begin(), commands_.end(), other.commands_.begin());
 }
 
 const int Route::findStop(FactoryKey index) const
 {
-    int stop = -1;
-    for (int i = 0; i < size(); i++)
-    {
-        if (stops_[i].first == index)
-        {
-            stop = i;
-            return stop;
-        }
-    }
-    return stop;
+    const FactoryKey* stop = std::find(keys_.begin(), keys_.end(), index);
+    return stop == keys_.end() ? -1 : int(stop - keys_.begin());
 }
 
 void Route::setResourceList(size_t stop, ResourceList updatedList)
 {
     if(stop >= size()) {throw std::out_of_range("Attempted to setResourceList outside of Route range");} // check for valid input
-    stops_[stop].second = updatedList;
+    commands_[stop] = updatedList;
+    invalidate(true);
 }
 
 void Route::setResource(size_t stop, Resource resource, Quant quantity)
 {
     if(stop >= size()) {throw std::out_of_range("Attempted to setResource outside of Route range");} // check for valid input
-    stops_[stop].second[resource] = quantity;
+    commands_[stop][resource] = quantity;
+    invalidate(true);
 }
 
-// Calculates which resources are effectively "carried over" from one cycle of the route to the next
-ResourceList Route::getCarryover() const {
+/////////////////////////////////////////////////////////////////
+// Information functions
+/////////////////////////////////////////////////////////////////
+
+void Route::invalidate(bool keep_length) {
+    // only called with exclusive access, so no one is computing
+    if(!keep_length || metrics_state_ == STALE)
+        metrics_state_ = STALE;
+    else
+        metrics_state_ = STALE_KEEP_LENGTH;
+}
+
+const Route::Metrics& Route::metrics() const {
+    uint8_t state = metrics_state_.load(std::memory_order_acquire);
+    while(state != READY) {
+        // claim the computation, or wait for whoever has it
+        if(state != COMPUTING && metrics_state_.compare_exchange_weak(state, COMPUTING, std::memory_order_acquire)) {
+            computeMetrics(state == STALE);
+            metrics_state_.store(READY, std::memory_order_release);
+            break;
+        }
+        if(state == COMPUTING)
+            std::this_thread::yield();
+        state = metrics_state_.load(std::memory_order_acquire);
+    }
+    return metrics_;
+}
+
+// O(s * R), one pass for the carryover and one for everything else
+void Route::computeMetrics(bool length) const {
+    // Calculates which resources are effectively "carried over" from one cycle of the route to the next
     // track resources currently carried by train
     ResourceList curr_resources;
     // add on positive Qs from first RL
-    for(Resource r = static_cast<Resource>(0); r != Resource::COUNT; r++)
-        if(stops_.front().second[r] > 0)
-            curr_resources[r] += stops_.front().second[r];
+    curr_resources += commands_[0].getPositiveList();
     // for each stop after the first
-    for(PairList<FactoryKey, ResourceList>::const_iterator it = stops_.cbegin(); ++it != stops_.cend(); ) {
+    for(size_t i = 1; i < size(); i++) {
         // add on RL
-        curr_resources = curr_resources + it->second;
+        curr_resources += commands_[i];
         // if RL would drop Q to negs, set Q to 0
         // the residue of these negative quants will be our carryover
-        for(Resource r = static_cast<Resource>(0); r != Resource::COUNT; r++)
-            if(curr_resources[r] < 0)
-                curr_resources[r] = 0;
+        curr_resources.clampNegative();
     }
     // to finish calculating carryover, apply negative quants from first factory
-    for(Resource r = static_cast<Resource>(0); r != Resource::COUNT; r++)
-        if(stops_.front().second[r] < 0)
-            curr_resources[r] += stops_.front().second[r];
-    
-    // return final carryover, which would be used to cover the negative Qs we suppressed
-    return curr_resources;
+    // the carryover would be used to cover the negative Qs we suppressed
+    curr_resources += commands_[0].getNegativeList();
+    metrics_.carryover = curr_resources;
+
+    // CarryTime = Dist*Quant
+    // Measures the total distance resources are carried in the route
+    // PeakCapacity is the maximum number of resources carried by the route at any given time
+    //  this effectively represents the necesasry capacity of the train
+
+    // order of ops for [F0, F1, F2, ..., Fn]
+    //  curr_resounces = carryover + (pos Qs from F0.RL)
+    //  for pairs (start, end) in [(F0, F1), (F1, F2), ..., (Fn, F0)]
+    //   curr_cap = sum over RL
+    //   d = dist(start, end)
+    //   carry_time += curr_cap * d;
+    //   curr_resounces += end.RL
+    // the peak is the largest curr_cap, from after F0 to after Fn
+    curr_resources += commands_[0].getPositiveList();
+    Quant curr_cap = curr_resources.total();
+    Dist total_length = {0, 0};
+    metrics_.carry_time = 0;
+    metrics_.peak_capacity = std::max(Quant(0), curr_cap);
+    // for each stop after the first, wrapping around to the first
+    for(size_t i = 1; i <= size(); i++) {
+        size_t end = i % size();
+        // calculate distance of this edge
+        Dist d = dist(keys_[i-1], keys_[end]);
+        if(length)
+            total_length += d;
+        // update carry time by cap * dist
+        // Qs in cap should never go negative
+        metrics_.carry_time += curr_cap * d.toDouble();
+
+        // add on RL from end factory
+        curr_resources += commands_[end];
+        curr_cap = curr_resources.total();
+        if(end != 0)
+            metrics_.peak_capacity = std::max(metrics_.peak_capacity, curr_cap);
+    }
+    if(length)
+        metrics_.length = total_length;
+}
+
+// Calculates which resources are effectively "carried over" from one cycle of the route to the next
+ResourceList Route::getCarryover() const {
+    return metrics().carryover;
 }
 
 // get total length of track this route uses
 Dist Route::getLength() const {
-    // start with no distance
-    Dist d = {0, 0};
-    // track the location of previous stop
-    // stop "before" first stop is the last stop
-    d += dist(stops_.at(0).first, stops_.at(size()-1).first);
-    // for each stop
-    for(int i = 1; i < size(); i++) {
-        // add dist between this stop and previous stop
-        d += dist(stops_.at(i).first, stops_.at(i-1).first);
-    }
-    // return total distance
-    return d;
+    return metrics().length;
 }
 
 // gets the number of factories that this route visits
@@ -216,101 +311,30 @@ size_t Route::getNumStops() const {
 
 // CarryTime = Dist*Quant
 // Measures the total distance resources are carried in the route
-
-// order of ops for [F0, F1, F2, ..., Fn]
-//  curr_resounces = carryover + (pos Qs from F0.RL)
-//  for pairs (start, end) in [(F0, F1), (F1, F2), ..., (Fn, F0)]
-//   curr_cap = sum over RL
-//   d = dist(start, end)
-//   carry_time += curr_cap * d;
-//   curr_resounces += end.RL
 double Route::getCarryTime() const {
-    // running total of resources currently on the train
-    ResourceList curr_resources = getCarryover();
-    // running total of carry time
-    double carry_time = 0;
-
-    // add on positive Qs from first RL
-    for(Resource r = static_cast<Resource>(0); r != Resource::COUNT; r++)
-        if(stops_.front().second[r] > 0)
-            curr_resources[r] += stops_.front().second[r];
-    
-    // for each stop after the first
-    FactoryKey start_fact = stops_.front().first;
-    bool loop_var = true;
-    for(PairList<FactoryKey, ResourceList>::const_iterator end_it = ++stops_.cbegin(); loop_var; end_it++) {        
-        // perform bound check
-        if(end_it == stops_.cend()) {
-            // mark loop ending
-            loop_var = false;
-            // set iter to start of array
-            end_it = stops_.cbegin();
-        }
-        // calculate distance of this edge
-        Dist d = dist(start_fact, end_it->first);
-
-        // find curr cap
-        Quant curr_cap = 0;
-        // Qs in cap should never go negative
-        for(Resource r = static_cast<Resource>(0); r != Resource::COUNT; r++)
-            curr_cap += curr_resources[r];
-        // update carry time by cap * dist
-        carry_time += curr_cap * d.toDouble();
-
-        // add on RL from end_it factory
-        curr_resources = curr_resources + end_it->second;
-
-        // update start funct
-        start_fact = end_it->first;
-    }
-    
-    // return carry time
-    return carry_time;
+    return metrics().carry_time;
 }
 
 // Returns the maximum number of resources carried by th route at any given time
 //  this effectively represents the necesasry capacity of the train
 Quant Route::getPeakCapacity() const {
-    // running track of current max capacity
-    Quant peak_cap = 0;
-    // running total of resources currently on the train
-    ResourceList curr_resources = getCarryover();
-
-    // for each stop after the first
-    for(PairList<FactoryKey, ResourceList>::const_iterator it = stops_.cbegin(); it != stops_.cend(); it++) {
-        // add on capacity of this Factory
-        // on first fact, only add positive
-        if(it == stops_.cbegin()) {
-            for(Resource r = static_cast<Resource>(0); r != Resource::COUNT; r++)
-                if(it->second[r] > 0)
-                    curr_resources[r] += it->second[r];
-        // else add all
-        } else {
-            curr_resources = curr_resources + it->second;
-        }
-
-        // find current capacity
-        Quant curr_cap = 0;
-        // on second iter, all Qs in cap should always be 
-        for(Resource r = static_cast<Resource>(0); r != Resource::COUNT; r++)
-            curr_cap += curr_resources[r];
-
-        // update max capacity
-        peak_cap = std::max(peak_cap, curr_cap);
-    }
-    
-    // return peak capacity
-    return peak_cap;
+    return metrics().peak_capacity;
 }
 
 void Route::reverse() {
     // no checks, cuz allocations aren't changing
     // reverse everything other than first stop
-    std::reverse(++stops_.begin(), stops_.end());    
+    std::reverse(keys_.begin() + 1, keys_.end());
+    std::reverse(commands_.begin() + 1, commands_.end());
+    // the same edges in the other direction
+    invalidate(true);
 }
 
 void Route::rotate(size_t n) {
-    n %= stops_.size();
+    n %= size();
 
-    std::rotate(stops_.begin(), stops_.begin()+n, stops_.end());
+    std::rotate(keys_.begin(), keys_.begin()+n, keys_.end());
+    std::rotate(commands_.begin(), commands_.begin()+n, commands_.end());
+    // the same edges from a different start
+    invalidate(true);
 }
\ No newline at end of file
@@ -0,0 +1,252 @@
+/*
+SparseResourceList definitions
+
+Definitions for the BasicSparseResourceList class.
+*/
+
+/////////////////
+// Includes
+/////////////////
+
+#include "../../headers/data/SparseResourceList.h"
+#include <algorithm>
+#include <stdexcept>
+
+/////////////////
+// Helpers
+/////////////////
+
+// bits of mask below bit r
+static inline uint64_t below(uint64_t mask, size_t r)
+{
+    return mask & ((uint64_t(1) << r) - 1);
+}
+
+/////////////////
+// Constructors
+/////////////////
+
+template <size_t N>
+BasicSparseResourceList<N>::BasicSparseResourceList() :
+    mask_(0),
+    inline_()
+{}
+
+// O(N)
+template <size_t N>
+BasicSparseResourceList<N>::BasicSparseResourceList(const BasicResourceList<N>& dense) :
+    mask_(0),
+    inline_()
+{
+    Quant packed[N];
+    size_t n = 0;
+    for (size_t r = 0; r < N; r++)
+    {
+        if (dense[r] != 0) {packed[n++] = dense[r];}
+    }
+    assign(dense.negativeMask() | dense.positiveMask(), packed);
+}
+
+template <size_t N>
+BasicSparseResourceList<N>::BasicSparseResourceList(const BasicSparseResourceList& other) :
+    mask_(0),
+    inline_()
+{
+    assign(other.mask_, other.values());
+}
+
+template <size_t N>
+BasicSparseResourceList<N>& BasicSparseResourceList<N>::operator=(const BasicSparseResourceList& other)
+{
+    if (this != &other) {assign(other.mask_, other.values());}
+    return *this;
+}
+
+// other's spill_ comes over with its Quants, so its mask_ is cleared to match
+template <size_t N>
+BasicSparseResourceList<N>::BasicSparseResourceList(BasicSparseResourceList&& other) noexcept :
+    mask_(other.mask_),
+    spill_(std::move(other.spill_))
+{
+    std::copy(other.inline_, other.inline_ + INLINE_CAPACITY, inline_);
+    other.mask_ = 0;
+}
+
+template <size_t N>
+BasicSparseResourceList<N>& BasicSparseResourceList<N>::operator=(BasicSparseResourceList&& other) noexcept
+{
+    if (this != &other)
+    {
+        mask_ = other.mask_;
+        std::copy(other.inline_, other.inline_ + INLINE_CAPACITY, inline_);
+        spill_ = std::move(other.spill_);
+        other.mask_ = 0;
+    }
+    return *this;
+}
+
+/////////////////
+// Functions
+/////////////////
+
+template <size_t N>
+const Quant* BasicSparseResourceList<N>::values() const
+{
+    return spill_ ? spill_.get() : inline_;
+}
+
+template <size_t N>
+Quant* BasicSparseResourceList<N>::values()
+{
+    return spill_ ? spill_.get() : inline_;
+}
+
+template <size_t N>
+size_t BasicSparseResourceList<N>::rank(size_t r) const
+{
+    return __builtin_popcountll(below(mask_, r));
+}
+
+template <size_t N>
+void BasicSparseResourceList<N>::assign(uint64_t mask, const Quant* packed)
+{
+    size_t n = __builtin_popcountll(mask);
+    if (n <= INLINE_CAPACITY)
+    {
+        std::copy(packed, packed + n, inline_);
+        spill_.reset();
+    }
+    else
+    {
+        std::unique_ptr<Quant[]> spill(new Quant[n]);
+        std::copy(packed, packed + n, spill.get());
+        spill_ = std::move(spill);
+    }
+    mask_ = mask;
+}
+
+template <size_t N>
+Quant BasicSparseResourceList<N>::operator[](size_t r) const
+{
+    if (r >= N) {throw std::out_of_range("Resource is not in this SparseResourceList");}
+    if (!((mask_ >> r) & 1)) {return 0;}
+    return values()[rank(r)];
+}
+
+// O(1) to change a set resource, O(count) to add or remove one
+template <size_t N>
+void BasicSparseResourceList<N>::set(size_t r, Quant q)
+{
+    if (r >= N) {throw std::out_of_range("Resource is not in this SparseResourceList");}
+    uint64_t bit = uint64_t(1) << r;
+    size_t i = rank(r), n = count();
+    if ((mask_ & bit) && q != 0)
+    {
+        values()[i] = q;
+        return;
+    }
+    if (!(mask_ & bit) && q == 0) {return;}
+
+    // add or remove r from the packed Quants
+    Quant packed[N];
+    const Quant* v = values();
+    std::copy(v, v + i, packed);
+    if (q != 0)
+    {
+        packed[i] = q;
+        std::copy(v + i, v + n, packed + i + 1);
+    }
+    else
+    {
+        std::copy(v + i + 1, v + n, packed + i);
+    }
+    assign(mask_ ^ bit, packed);
+}
+
+template <size_t N>
+uint64_t BasicSparseResourceList<N>::mask() const
+{
+    return mask_;
+}
+
+template <size_t N>
+uint64_t BasicSparseResourceList<N>::negativeMask() const
+{
+    uint64_t neg = 0;
+    forEach([&neg](size_t r, Quant q) { neg |= uint64_t(q < 0) << r; });
+    return neg;
+}
+
+template <size_t N>
+uint64_t BasicSparseResourceList<N>::positiveMask() const
+{
+    return mask_ & ~negativeMask();
+}
+
+template <size_t N>
+size_t BasicSparseResourceList<N>::count() const
+{
+    return __builtin_popcountll(mask_);
+}
+
+template <size_t N>
+bool BasicSparseResourceList<N>::isEmpty() const
+{
+    return mask_ == 0;
+}
+
+template <size_t N>
+Quant BasicSparseResourceList<N>::total() const
+{
+    const Quant* v = values();
+    Quant sum = 0;
+    for (size_t i = 0, n = count(); i < n; i++)
+    {
+        sum += v[i];
+    }
+    return sum;
+}
+
+template <size_t N>
+BasicResourceList<N> BasicSparseResourceList<N>::toDense() const
+{
+    BasicResourceList<N> dense;
+    addTo(dense);
+    return dense;
+}
+
+template <size_t N>
+void BasicSparseResourceList<N>::addTo(BasicResourceList<N>& dense) const
+{
+    forEach([&dense](size_t r, Quant q) { dense[r] += q; });
+}
+
+template <size_t N>
+void BasicSparseResourceList<N>::subtractFrom(BasicResourceList<N>& dense) const
+{
+    forEach([&dense](size_t r, Quant q) { dense[r] -= q; });
+}
+
+template <size_t N>
+BasicSparseResourceList<N> BasicSparseResourceList<N>::negated() const
+{
+    BasicSparseResourceList out(*this);
+    Quant* v = out.values();
+    for (size_t i = 0, n = count(); i < n; i++)
+    {
+        v[i] = -v[i];
+    }
+    return out;
+}
+
+template <size_t N>
+bool BasicSparseResourceList<N>::operator==(const BasicSparseResourceList& other) const
+{
+    return mask_ == other.mask_ && std::equal(values(), values() + count(), other.values());
+}
+
+/////////////////
+// Instantiations
+/////////////////
+
+template class BasicSparseResourceList<Resource::COUNT>;
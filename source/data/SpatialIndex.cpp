@@ -0,0 +1,199 @@
+/*
+SpatialIndex definitions
+
+Definitions for the SpatialIndex grid.
+*/
+
+/////////////////
+// Includes
+/////////////////
+
+#include "../../headers/data/SpatialIndex.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+
+/////////////////
+// Helpers
+/////////////////
+
+// rounds towards negative infinity, unlike /
+static int64_t floorDiv(int64_t a, int64_t b)
+{
+    int64_t q = a / b;
+    return (a % b != 0 && (a < 0) != (b < 0)) ? q - 1 : q;
+}
+
+/////////////////
+// Constructor
+/////////////////
+
+// O(n)
+SpatialIndex::SpatialIndex(const std::vector<Location>& locs, Coord cell_size) :
+    locs_(locs),
+    min_x_(0),
+    min_y_(0),
+    cell_(1),
+    cols_(0),
+    rows_(0)
+{
+    if (locs_.empty()) {return;}
+
+    // bounding box
+    Coord max_x = locs_[0].x, max_y = locs_[0].y;
+    min_x_ = locs_[0].x;
+    min_y_ = locs_[0].y;
+    for (const Location& l : locs_)
+    {
+        min_x_ = std::min(min_x_, l.x);
+        min_y_ = std::min(min_y_, l.y);
+        max_x = std::max(max_x, l.x);
+        max_y = std::max(max_y, l.y);
+    }
+    int64_t width = int64_t(max_x) - min_x_ + 1, height = int64_t(max_y) - min_y_ + 1;
+
+    // about one point per cell unless told otherwise
+    if (cell_size > 0) {cell_ = cell_size;}
+    else {cell_ = std::max<int64_t>(1, std::ceil(std::sqrt(double(width) * double(height) / locs_.size())));}
+    // never use many more cells than points
+    while (((width - 1) / cell_ + 1) * ((height - 1) / cell_ + 1) > int64_t(4 * locs_.size() + 16)) {cell_ *= 2;}
+    cols_ = (width - 1) / cell_ + 1;
+    rows_ = (height - 1) / cell_ + 1;
+
+    // bucket points by cell (counting sort)
+    cell_start_.assign(cols_ * rows_ + 1, 0);
+    std::vector<uint32_t> cell_of(locs_.size());
+    for (size_t i = 0; i < locs_.size(); i++)
+    {
+        cell_of[i] = cellY(locs_[i].y) * cols_ + cellX(locs_[i].x);
+        cell_start_[cell_of[i] + 1]++;
+    }
+    for (size_t c = 1; c < cell_start_.size(); c++)
+    {
+        cell_start_[c] += cell_start_[c - 1];
+    }
+    items_.resize(locs_.size());
+    std::vector<uint32_t> fill(cell_start_.begin(), cell_start_.end() - 1);
+    for (size_t i = 0; i < locs_.size(); i++)
+    {
+        items_[fill[cell_of[i]]++] = i;
+    }
+}
+
+/////////////////
+// Functions
+/////////////////
+
+int64_t SpatialIndex::cellX(int64_t x) const
+{
+    return floorDiv(x - min_x_, cell_);
+}
+
+int64_t SpatialIndex::cellY(int64_t y) const
+{
+    return floorDiv(y - min_y_, cell_);
+}
+
+size_t SpatialIndex::size() const
+{
+    return locs_.size();
+}
+
+const Location& SpatialIndex::getLoc(size_t i) const
+{
+    return locs_.at(i);
+}
+
+// O(cells in radius + points in those cells)
+std::vector<size_t> SpatialIndex::withinRadius(Location center, Dist radius) const
+{
+    std::vector<size_t> found;
+    if (locs_.empty()) {return found;}
+
+    // dist() is never less than the largest coordinate difference,
+    // so only cells in a square of side 2*radius can hold matches
+    int64_t r = std::ceil(radius.toDouble());
+    int64_t x0 = std::max<int64_t>(0, cellX(int64_t(center.x) - r)), x1 = std::min(cols_ - 1, cellX(int64_t(center.x) + r));
+    int64_t y0 = std::max<int64_t>(0, cellY(int64_t(center.y) - r)), y1 = std::min(rows_ - 1, cellY(int64_t(center.y) + r));
+    for (int64_t y = y0; y <= y1; y++)
+    {
+        for (int64_t x = x0; x <= x1; x++)
+        {
+            int64_t c = y * cols_ + x;
+            for (uint32_t i = cell_start_[c]; i < cell_start_[c + 1]; i++)
+            {
+                if (dist(center, locs_[items_[i]]) <= radius) {found.push_back(items_[i]);}
+            }
+        }
+    }
+    std::sort(found.begin(), found.end());
+    return found;
+}
+
+// O(k log k + points in the searched rings)
+//   searches rings of cells outwards from center until no closer point can be found
+std::vector<size_t> SpatialIndex::kNearest(Location center, size_t k) const
+{
+    k = std::min(k, locs_.size());
+    std::vector<size_t> found;
+    if (k == 0) {return found;}
+
+    // max heap of the best k so far, by (distance, index)
+    typedef std::pair<Dist, size_t> Candidate;
+    std::vector<Candidate> best;
+    auto visitCell = [&](int64_t x, int64_t y) {
+        int64_t c = y * cols_ + x;
+        for (uint32_t i = cell_start_[c]; i < cell_start_[c + 1]; i++)
+        {
+            Candidate cand(dist(center, locs_[items_[i]]), items_[i]);
+            if (best.size() < k)
+            {
+                best.push_back(cand);
+                std::push_heap(best.begin(), best.end());
+            }
+            else if (cand < best.front())
+            {
+                std::pop_heap(best.begin(), best.end());
+                best.back() = cand;
+                std::push_heap(best.begin(), best.end());
+            }
+        }
+    };
+
+    int64_t cx = cellX(center.x), cy = cellY(center.y);
+    // first ring that touches the grid, and the ring that covers all of it
+    int64_t r_min = std::max({int64_t(0), -cx, cx - (cols_ - 1), -cy, cy - (rows_ - 1)});
+    int64_t r_max = std::max({cx, (cols_ - 1) - cx, cy, (rows_ - 1) - cy});
+    for (int64_t r = r_min; r <= r_max; r++)
+    {
+        // every point in ring r is at least (r-1)*cell_ away
+        // (clamped to a Coord, which only makes it looser)
+        Dist lower_bound = {Coord(std::min<int64_t>(r > 0 ? (r - 1) * cell_ : 0, INT32_MAX)), 0};
+        if (best.size() == k && best.front().first < lower_bound) {break;}
+
+        int64_t x0 = std::max<int64_t>(0, cx - r), x1 = std::min(cols_ - 1, cx + r);
+        int64_t y0 = std::max<int64_t>(0, cy - r), y1 = std::min(rows_ - 1, cy + r);
+        // top and bottom rows of the ring
+        for (int64_t y : {cy - r, cy + r})
+        {
+            if (y < 0 || y >= rows_) {continue;}
+            for (int64_t x = x0; x <= x1; x++) {visitCell(x, y);}
+            if (r == 0) {break;}
+        }
+        // left and right columns, without the corners
+        if (r == 0) {continue;}
+        for (int64_t x : {cx - r, cx + r})
+        {
+            if (x < 0 || x >= cols_) {continue;}
+            for (int64_t y = std::max(y0, cy - r + 1); y <= std::min(y1, cy + r - 1); y++) {visitCell(x, y);}
+        }
+    }
+
+    std::sort_heap(best.begin(), best.end());
+    for (const Candidate& cand : best)
+    {
+        found.push_back(cand.second);
+    }
+    return found;
+}
@@ -3,7 +3,12 @@ main file
 Author: Ethan Worth, Andrew Bergman, Mason Paladino, Nozomu Ohno
 11/19/22
 
-main lives here.
+main lives here. It is a command line driver for the solvers: it
+loads or generates networks, solves them with the solver and
+parameters given on the command line, and reports the cost and how
+long each solve took. With --workers the networks are solved as one
+batch on a pool of workers instead of one after another. Run with
+--help for the options.
 */
 
 /////////////////
@@ -20,59 +25,339 @@ main lives here.
 // Includes
 /////////////////
 
+#include <chrono>
+#include <ctime>
+#include <fstream>
 #include <iostream>
-#include <list>
-#include <time.h>
-#include "../headers/solutions/solvers/GreedyEdgeList.h"
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "../headers/data/NetworkFile.h"
+#include "../headers/solutions/BatchSolver.h"
 #include "../headers/solutions/CanonicalExamples.h"
+#include "../headers/solutions/FactoryImport.h"
+#include "../headers/solutions/SolutionWriter.h"
+#include "../headers/solutions/SolverConfig.h"
 
 /////////////////
-// main
+// Options
 /////////////////
 
-int main() {
-    const std::list<Network> CANON_NETS = {
-        CANON_BASIC,
-        CANON_DUAL_SERVE,
-        CANON_DUAL_RES_PRODUCE,
-        CANON_TWO_ZONES,
-        CANON_TRI_CYCLE
-    };
-    std::list<std::pair<int,int>> m = {
-        {29259, 35},
-        {14173, 185},
-        {27464, 355},
-        {8787, 925},
-        {23412, 995}
-    };
-    /*std::list<std::pair<int,int>> m = {
-        {21442, 52}
-    };*/
-    Constraints CONS;
-    Coord MAX_LOC_COORD = 1000, NUM_ITERS = 10;
-    const int numFacts = 50;
-    size_t start = time(0);
-    for(auto p : m){
-    //for(auto net : CANON_NETS) {
-        std::cout << p.first << ", " << p.second << std::endl;
-        Network net = randomNetwork(p.first, numFacts, p.second);
-        //Network net = randomNetwork(p.first, p.second, p.second*10);
-        GreedyEdgeList solv(net, ALL_COSTS, CONS);
-        Cost init_cost = ALL_COSTS(solv.finishNetwork(solv.getNet()));
-        Network solved = solv.solve();
-        std::cout << CONS(solved) << ' ' << ALL_COSTS(solved) << " <= " << init_cost << std::endl;
-        for(auto h : solv.getHistory()) {
-            //std::cout << h.first.getNumRoutes() << " => " << h.second << std::endl;
+const char* const USAGE =
+    "usage: solver [options] (--input PATH | --list PATH | --random SEED)...\n"
+    "\n"
+    "networks, solved in the order given:\n"
+    "  --input PATH         network file, or a factory list (CSV or JSON lines)\n"
+    "  --list PATH          file of --input paths, one per line, # starts a comment\n"
+    "  --random SEED        random network, see --factories and --max-coord\n"
+    "  --factories N        factories in random networks (50)\n"
+    "  --max-coord C        random factories are placed in [-C, C) (1000)\n"
+    "\n"
+    "solver:\n"
+    "  --solver NAME        GreedyEdgeList or Genetic (GreedyEdgeList)\n"
+    "  --dist-w W           distance weight of finish edges (1)\n"
+    "  --quant-w W          quantity weight of finish edges (3)\n"
+    "  --track T            GreedyEdgeList networks tracked while polishing (5)\n"
+    "  --iters N            Genetic generations (100)\n"
+    "  --threads N          threads per solve, 0 uses every hardware thread (1)\n"
+    "  --seed S             random seed of the solver\n"
+    "\n"
+    "batch:\n"
+    "  --workers N          solves the networks N at a time, reporting each as it\n"
+    "                       finishes, 0 uses every hardware thread\n"
+    "\n"
+    "cost:\n"
+    "  --costs all|simple   starting weights, ALL_COSTS or SIMPLE_COSTS (all)\n"
+    "  --weight METRIC=W    weight of one metric, like MaxLength=0.5\n"
+    "  --undirected-track   track is shared by routes running it either way\n"
+    "\n"
+    "output:\n"
+    "  --output PATH        writes each solution, numbered after the first\n"
+    "  --format json|binary format of --output (json)\n";
+
+// a network to solve and where it came from
+struct Input {
+    std::string path; // empty for a random network
+    int seed;
+};
+
+struct Options {
+    std::vector<Input> inputs;
+    int num_factories = 50;
+    int max_coord = 1000;
+    SolverConfig config;
+    bool batch = false; // set by --workers
+    size_t workers = 0;
+    std::string output;
+    SolutionWriter::Format format = SolutionWriter::JSON_LINES;
+};
+
+// the whole of text as a number, throws invalid_argument naming the option otherwise
+template <typename T>
+static T parseNumber(const std::string& option, const std::string& text)
+{
+    size_t used = 0;
+    T value;
+    try
+    {
+        if (std::is_floating_point<T>::value) {value = T(std::stod(text, &used));}
+        else if (std::is_signed<T>::value) {value = T(std::stoll(text, &used));}
+        else {value = T(std::stoull(text, &used));}
+    }
+    catch (const std::exception&)
+    {
+        used = 0;
+    }
+    if (used == 0 || used != text.size() || (std::is_unsigned<T>::value && text[0] == '-'))
+    {
+        throw std::invalid_argument(option + " expects a number, not '" + text + "'");
+    }
+    return value;
+}
+
+// the paths listed in a --list file, throws invalid_argument if it can't be read
+static void readList(const std::string& path, std::vector<Input>& inputs)
+{
+    std::ifstream in(path);
+    if (!in) {throw std::invalid_argument("can't open list '" + path + "'");}
+    std::string line;
+    while (std::getline(in, line))
+    {
+        line = line.substr(0, line.find('#'));
+        size_t first = line.find_first_not_of(" \t\r"), last = line.find_last_not_of(" \t\r");
+        if (first != std::string::npos) {inputs.push_back({line.substr(first, last - first + 1), 0});}
+    }
+}
+
+// throws invalid_argument for anything that isn't a valid option
+static Options parseOptions(int argc, char** argv)
+{
+    Options opts;
+    for (int i = 1; i < argc; i++)
+    {
+        std::string option = argv[i];
+        // every option but the flags takes one value
+        auto value = [&]() -> std::string {
+            if (i + 1 >= argc) {throw std::invalid_argument(option + " expects a value");}
+            return argv[++i];
+        };
+
+        if (option == "--input") {opts.inputs.push_back({value(), 0});}
+        else if (option == "--list") {readList(value(), opts.inputs);}
+        else if (option == "--random") {opts.inputs.push_back({"", parseNumber<int>(option, value())});}
+        else if (option == "--factories") {opts.num_factories = parseNumber<int>(option, value());}
+        else if (option == "--max-coord") {opts.max_coord = parseNumber<int>(option, value());}
+        else if (option == "--solver")
+        {
+            std::string name = value();
+            if (!parseAlgorithm(name, opts.config.algorithm)) {throw std::invalid_argument("unknown solver '" + name + "'");}
+        }
+        else if (option == "--dist-w") {opts.config.dist_w = parseNumber<double>(option, value());}
+        else if (option == "--quant-w") {opts.config.quant_w = parseNumber<double>(option, value());}
+        else if (option == "--track") {opts.config.track = parseNumber<size_t>(option, value());}
+        else if (option == "--iters") {opts.config.num_iters = parseNumber<size_t>(option, value());}
+        else if (option == "--threads") {opts.config.threads = parseNumber<size_t>(option, value());}
+        else if (option == "--seed") {opts.config.seed = parseNumber<uint64_t>(option, value());}
+        else if (option == "--workers")
+        {
+            opts.batch = true;
+            opts.workers = parseNumber<size_t>(option, value());
         }
+        else if (option == "--costs")
+        {
+            std::string name = value();
+            bool undirected = opts.config.cost.undirected_track;
+            if (name == "all") {opts.config.cost = ALL_COSTS;}
+            else if (name == "simple") {opts.config.cost = SIMPLE_COSTS;}
+            else {throw std::invalid_argument("--costs expects all or simple, not '" + name + "'");}
+            opts.config.cost.undirected_track = undirected;
+        }
+        else if (option == "--weight")
+        {
+            std::string pair = value();
+            size_t eq = pair.find('=');
+            CostFunct::Metric m;
+            if (eq == std::string::npos || !parseMetric(std::string_view(pair).substr(0, eq), m))
+            {
+                throw std::invalid_argument("--weight expects METRIC=W, not '" + pair + "'");
+            }
+            opts.config.cost.weights[m] = parseNumber<double>(option, pair.substr(eq + 1));
+        }
+        else if (option == "--undirected-track") {opts.config.cost.undirected_track = true;}
+        else if (option == "--output") {opts.output = value();}
+        else if (option == "--format")
+        {
+            std::string name = value();
+            if (name == "json") {opts.format = SolutionWriter::JSON_LINES;}
+            else if (name == "binary") {opts.format = SolutionWriter::BINARY;}
+            else {throw std::invalid_argument("--format expects json or binary, not '" + name + "'");}
+        }
+        else {throw std::invalid_argument("unknown option '" + option + "'");}
+    }
+    if (opts.inputs.empty()) {throw std::invalid_argument("no networks given, use --input, --list or --random");}
+    return opts;
+}
+
+/////////////////
+// Solving
+/////////////////
+
+static std::string inputName(const Input& input)
+{
+    return input.path.empty() ? "random " + std::to_string(input.seed) : input.path;
+}
+
+static Network loadInput(const Options& opts, const Input& input)
+{
+    if (input.path.empty())
+    {
+        // randomNetwork seeds and draws from the global rand(), batch workers take turns
+        static std::mutex random_mutex;
+        std::lock_guard<std::mutex> lock(random_mutex);
+        return randomNetwork(input.seed, opts.num_factories, opts.max_coord);
     }
-    size_t end = time(0);
-    std::cout << end - start << std::endl;
-    // 44 on old solver
-    // 2-3 on new
+    if (isNetworkFile(input.path)) {return readNetworkFile(input.path);}
+    return importFactories(input.path);
+}
 
-    return 0;
+// output path for the nth solution, the first one is written to path itself
+static std::string outputPath(const std::string& path, size_t n)
+{
+    if (n == 0) {return path;}
+    size_t dot = path.find_last_of('.'), slash = path.find_last_of("/\\");
+    if (dot == std::string::npos || (slash != std::string::npos && dot < slash)) {dot = path.size();}
+    return path.substr(0, dot) + "." + std::to_string(n) + path.substr(dot);
 }
 
-/*
--157, -495
-*/
\ No newline at end of file
+// microseconds since start
+static long long microsSince(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+}
+static long long cpuMicrosSince(std::clock_t start)
+{
+    return (long long)((std::clock() - start) * (1000000.0 / CLOCKS_PER_SEC));
+}
+
+// solves the inputs one after another, returns the exit status
+static int solveInOrder(const Options& opts)
+{
+    const SolverConfig& config = opts.config;
+    int status = 0;
+    for (size_t n = 0; n < opts.inputs.size(); n++)
+    {
+        const Input& input = opts.inputs[n];
+        std::cout << inputName(input) << std::endl;
+        try
+        {
+            auto start = std::chrono::steady_clock::now();
+            Network net = loadInput(opts, input);
+            long long load_us = microsSince(start);
+
+            start = std::chrono::steady_clock::now();
+            std::clock_t cpu = std::clock();
+            Network solved = config.makeSolver(net)->solve();
+            long long solve_us = microsSince(start), solve_cpu_us = cpuMicrosSince(cpu);
+
+            std::cout << "  factories: " << net.getNumFactories() << ", junctions: " << net.getNumJunctions()
+                << ", routes: " << solved.getNumRoutes() << std::endl;
+            std::cout << "  valid: " << config.constraints(solved) << ", cost: " << config.cost(solved) << std::endl;
+            std::cout << "  load: " << load_us << " us, solve: " << solve_us << " us wall, "
+                << solve_cpu_us << " us cpu" << std::endl;
+            if (!opts.output.empty()) {writeSolution(solved, config.cost, outputPath(opts.output, n), opts.format);}
+        }
+        catch (const std::exception& e)
+        {
+            std::cerr << "error: " << e.what() << std::endl;
+            status = 1;
+        }
+    }
+    return status;
+}
+
+// solves the inputs as one batch, reporting each as it finishes. Returns the exit status
+static int solveBatch(const Options& opts)
+{
+    const SolverConfig& config = opts.config;
+    BatchSolver batch(config, opts.workers);
+    for (const Input& input : opts.inputs)
+    {
+        batch.add(inputName(input), [&opts, &input]() { return loadInput(opts, input); });
+    }
+
+    int status = 0;
+    BatchStats stats = batch.run([&](const BatchResult& result) {
+        if (!result.error.empty())
+        {
+            std::cerr << result.name << "\nerror: " << result.error << std::endl;
+            status = 1;
+            return;
+        }
+        // one write per network, so the lines of networks finishing together don't interleave
+        std::ostringstream report;
+        report << result.name << "\n";
+        report << "  factories: " << result.solution.getNumFactories() << ", junctions: "
+            << result.solution.getNumJunctions() << ", routes: " << result.solution.getNumRoutes() << "\n";
+        report << "  valid: " << result.valid << ", cost: " << result.cost << "\n";
+        report << "  load: " << result.load_us << " us, solve: " << result.solve_us << " us wall, "
+            << result.solve_cpu_us << " us cpu\n";
+        std::cout << report.str() << std::flush;
+        try
+        {
+            if (!opts.output.empty())
+            {
+                writeSolution(result.solution, config.cost, outputPath(opts.output, result.index), opts.format);
+            }
+        }
+        catch (const std::exception& e)
+        {
+            std::cerr << "error: " << e.what() << std::endl;
+            status = 1;
+        }
+    });
+    std::cout << "batch: " << stats.solved << " solved, " << stats.failed << " failed, "
+        << stats.networksPerSecond() << " networks/s, " << stats.solve_cpu_us << " us solve cpu ("
+        << stats.cpuMicrosPerNetwork() << " us per network)" << std::endl;
+    std::cout << "scratch: " << stats.memory.allocations << " allocations, "
+        << stats.memory.upstream_allocations << " from the pools" << std::endl;
+    return status;
+}
+
+/////////////////
+// main
+/////////////////
+
+int main(int argc, char** argv) {
+    for (int i = 1; i < argc; i++)
+    {
+        if (std::string(argv[i]) == "--help" || std::string(argv[i]) == "-h")
+        {
+            std::cout << USAGE;
+            return 0;
+        }
+    }
+    Options opts;
+    try
+    {
+        opts = parseOptions(argc, argv);
+    }
+    catch (const std::invalid_argument& e)
+    {
+        std::cerr << "error: " << e.what() << "\n\n" << USAGE;
+        return 2;
+    }
+
+    const SolverConfig& config = opts.config;
+    std::cout << "solver: " << algorithmName(config.algorithm) << ", threads: " << config.threads
+        << ", seed: " << config.seed;
+    if (opts.batch) {std::cout << ", workers: " << opts.workers;}
+    std::cout << std::endl;
+
+    auto total_start = std::chrono::steady_clock::now();
+    std::clock_t total_cpu = std::clock();
+    int status = opts.batch ? solveBatch(opts) : solveInOrder(opts);
+    std::cout << "total: " << microsSince(total_start) << " us wall, " << cpuMicrosSince(total_cpu) << " us cpu" << std::endl;
+    return status;
+}
@@ -0,0 +1,112 @@
+/*
+ArenaResource definitions
+
+Definitions for MemoryStats, CountingResource and ArenaResource.
+*/
+
+/////////////////
+// Includes
+/////////////////
+
+#include "../../headers/solutions/ArenaResource.h"
+
+/////////////////
+// MemoryStats
+/////////////////
+
+MemoryStats& MemoryStats::operator+=(const MemoryStats& other)
+{
+    allocations += other.allocations;
+    bytes += other.bytes;
+    upstream_allocations += other.upstream_allocations;
+    upstream_bytes += other.upstream_bytes;
+    return *this;
+}
+
+/////////////////
+// CountingResource
+/////////////////
+
+CountingResource::CountingResource(std::pmr::memory_resource* upstream) :
+    upstream_(upstream)
+{}
+
+void* CountingResource::do_allocate(size_t bytes, size_t alignment)
+{
+    void* p = upstream_->allocate(bytes, alignment);
+    stats_.allocations++;
+    stats_.bytes += bytes;
+    stats_.upstream_allocations++;
+    stats_.upstream_bytes += bytes;
+    return p;
+}
+
+void CountingResource::do_deallocate(void* p, size_t bytes, size_t alignment)
+{
+    upstream_->deallocate(p, bytes, alignment);
+}
+
+bool CountingResource::do_is_equal(const std::pmr::memory_resource& other) const noexcept
+{
+    return this == &other;
+}
+
+const MemoryStats& CountingResource::getStats() const
+{
+    return stats_;
+}
+
+MemoryStats CountingResource::takeStats()
+{
+    MemoryStats stats = stats_;
+    stats_ = MemoryStats();
+    return stats;
+}
+
+/////////////////
+// ArenaResource
+/////////////////
+
+ArenaResource::ArenaResource(std::pmr::memory_resource* upstream) :
+    upstream_(upstream),
+    arena_(&upstream_)
+{}
+
+void* ArenaResource::do_allocate(size_t bytes, size_t alignment)
+{
+    void* p = arena_.allocate(bytes, alignment);
+    stats_.allocations++;
+    stats_.bytes += bytes;
+    return p;
+}
+
+void ArenaResource::do_deallocate(void*, size_t, size_t)
+{
+    // given back all at once by reset
+}
+
+bool ArenaResource::do_is_equal(const std::pmr::memory_resource& other) const noexcept
+{
+    return this == &other;
+}
+
+void ArenaResource::reset()
+{
+    arena_.release();
+}
+
+MemoryStats ArenaResource::getStats() const
+{
+    MemoryStats stats = stats_;
+    stats.upstream_allocations = upstream_.getStats().upstream_allocations;
+    stats.upstream_bytes = upstream_.getStats().upstream_bytes;
+    return stats;
+}
+
+MemoryStats ArenaResource::takeStats()
+{
+    MemoryStats stats = getStats();
+    stats_ = MemoryStats();
+    upstream_.takeStats();
+    return stats;
+}
@@ -0,0 +1,152 @@
+/*
+BatchSolver definitions
+
+Definitions for the BatchSolver class.
+*/
+
+/////////////////
+// Includes
+/////////////////
+
+#include "../../headers/solutions/BatchSolver.h"
+#include "../../headers/solutions/ThreadPool.h"
+#include <chrono>
+#include <ctime>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+
+/////////////////
+// Helpers
+/////////////////
+
+static long long microsSince(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+// CPU time of the calling thread, so jobs running side by side don't count each other's
+static long long threadCpuMicros()
+{
+    timespec t;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &t);
+    return t.tv_sec * 1000000LL + t.tv_nsec / 1000;
+}
+
+double BatchStats::networksPerSecond() const
+{
+    return wall_us > 0 ? (solved + failed) * 1e6 / wall_us : 0.0;
+}
+
+double BatchStats::cpuMicrosPerNetwork() const
+{
+    return solved > 0 ? double(solve_cpu_us) / solved : 0.0;
+}
+
+/////////////////
+// Constructors
+/////////////////
+
+BatchSolver::BatchSolver(const SolverConfig& config, size_t workers) :
+    config_(config),
+    num_workers_(workers)
+{}
+
+/////////////////
+// Functions
+/////////////////
+
+void BatchSolver::add(const std::string& name, Loader load)
+{
+    jobs_.push_back({name, std::move(load)});
+}
+
+void BatchSolver::add(const std::string& name, const Network& net)
+{
+    add(name, [net]() { return net; });
+}
+
+size_t BatchSolver::size() const
+{
+    return jobs_.size();
+}
+
+BatchStats BatchSolver::run(const ResultHandler& on_result)
+{
+    auto start = std::chrono::steady_clock::now();
+    ThreadPool pool(num_workers_);
+
+    // at most pool.size() jobs run at once, each takes a free pool for its solver's arenas.
+    // The pools are synchronized in case the solver runs on several threads itself.
+    std::vector<std::unique_ptr<std::pmr::synchronized_pool_resource>> memory;
+    std::vector<size_t> free_memory;
+    for (size_t i = 0; i < pool.size(); i++)
+    {
+        memory.emplace_back(new std::pmr::synchronized_pool_resource());
+        free_memory.push_back(i);
+    }
+
+    std::mutex mutex; // guards free_memory, stats and stopped, and serializes on_result
+    BatchStats stats;
+    bool stopped = false; // on_result threw, the jobs left are skipped
+    std::vector<Job> jobs;
+    jobs.swap(jobs_);
+    pool.parallelFor(jobs.size(), [&](size_t i) {
+        size_t slot;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (stopped) {return;}
+            slot = free_memory.back();
+            free_memory.pop_back();
+        }
+
+        BatchResult result;
+        result.index = i;
+        result.name = jobs[i].name;
+        result.valid = false;
+        result.cost = 0;
+        result.load_us = result.solve_us = result.solve_cpu_us = 0;
+        MemoryStats job_memory;
+        try
+        {
+            auto job_start = std::chrono::steady_clock::now();
+            Network net = jobs[i].load();
+            jobs[i].load = Loader(); // let go of anything the loader holds
+            result.load_us = microsSince(job_start);
+
+            job_start = std::chrono::steady_clock::now();
+            long long cpu_start = threadCpuMicros();
+            std::unique_ptr<Solver> solver = config_.makeSolver(net);
+            solver->setMemoryResource(memory[slot].get());
+            result.solution = solver->solve();
+            result.solve_us = microsSince(job_start);
+            result.solve_cpu_us = threadCpuMicros() - cpu_start;
+            job_memory = solver->getMemoryStats();
+            result.valid = config_.constraints(result.solution);
+            result.cost = config_.cost(result.solution);
+        }
+        catch (const std::exception& e)
+        {
+            result.error = e.what();
+            result.solution = Network();
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        free_memory.push_back(slot);
+        stats.memory += job_memory;
+        stats.solve_cpu_us += result.solve_cpu_us;
+        if (result.error.empty()) {stats.solved++;}
+        else {stats.failed++;}
+        try
+        {
+            on_result(result);
+        }
+        catch (...)
+        {
+            stopped = true;
+            throw;
+        }
+    });
+    stats.wall_us = microsSince(start);
+    return stats;
+}
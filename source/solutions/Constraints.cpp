@@ -39,18 +39,24 @@ bool Constraints::isValidSolution(const Network& net) const
     );
 }
 
+// O(1)
+bool Constraints::quickCheck(const Network& net) const
+{
+    return net.getNumTwiceViolations() == 0 && net.getNumDeficits() == 0;
+}
+
 // O(r * f_r)
 bool Constraints::checkTwice(const Network& net) const
 {
     // iterate over each route in the network
-    for (std::vector<Route>::const_iterator route = net.routeCBegin(); route != net.routeCEnd(); route++)
+    for (Network::RouteIterator route = net.routeCBegin(); route != net.routeCEnd(); route++)
     {
         // check that the first and last factory of the route are different
         if ((route->cbegin()->first) == ((--route->cend())->first))
             return false;
         
         // iterate over each factory in the route
-        for(PairList<FactoryKey, ResourceList>::const_iterator factory = ++route->cbegin(); factory != route->cend(); factory++)
+        for(Route::const_iterator factory = ++route->cbegin(); factory != route->cend(); factory++)
             if (factory->first == std::prev(factory)->first)
                 return false;
     }
@@ -63,12 +69,10 @@ bool Constraints::checkTwice(const Network& net) const
 bool Constraints::checkSatisfied(const Network& net) const
 {
     // iterate over all factories in the network and check that they are satisfied
-    for (std::map<FactoryKey, Factory, LocationCompare>::const_iterator fact_it = net.factCBegin(); fact_it != net.factCEnd(); fact_it++)
+    for (FactoryId id : net.getPlaceIds())
     {
-        ResourceList unallocated = fact_it->second.getUnallocated();
-        for (Resource resource = static_cast<Resource>(0); resource < Resource::COUNT; resource++)
-            if (unallocated[resource] < 0)
-                return false;
+        if (!net.getPlaceUnallocated(id).allPositive())
+            return false;
     }
     return true;
     // TODO: write tests for this
@@ -86,18 +90,10 @@ bool Constraints::checkNetResources(const Network& net) const
 {
     ResourceList runningTotal;
     // iterate over all factories in the network and add the supply and demand for each resource to the running total
-    for (std::map<FactoryKey, Factory, LocationCompare>::const_iterator fact_it = net.factCBegin(); fact_it != net.factCEnd(); fact_it++)
+    for (FactoryId id : net.getPlaceIds())
     {
-        ResourceList baseProduction = fact_it->second.getBaseQuants();
-        for (Resource resource = static_cast<Resource>(0); resource < Resource::COUNT; resource++)
-        {
-            runningTotal[resource] += baseProduction[resource];
-        }
+        runningTotal += net.getPlaceBaseQuants(id);
     }
     // check for negative net quant
-    for (Resource resource = static_cast<Resource>(0); resource < Resource::COUNT; resource++)
-        if (runningTotal[resource] < 0)
-            return false;
-    // else return true
-    return true;
+    return runningTotal.allPositive();
 }
\ No newline at end of file
@@ -12,6 +12,8 @@ Definitions for CostFunct's
 /////////////////
 #include "../../headers/solutions/CostFunct.h"
 #include <math.h>
+#include <algorithm>
+#include <stdexcept>
 
 /////////////////
 // Metric Functions
@@ -25,16 +27,39 @@ CostFunct::Metric operator++(CostFunct::Metric& m, int) {
     return orig;
 }
 
+static const char* const METRIC_NAMES[CostFunct::Metric::COUNT] = {
+    "NumJunctions", "BaseTrackLength", "SharedTrackLength", "MaxLength", "NumRoutes",
+    "MaxCarryTime", "TotalCarryTime", "MaxPeakCapacity", "TotalPeakCapacity"
+};
+
+const char* metricName(CostFunct::Metric m) {
+    if(m < 0 || m >= CostFunct::Metric::COUNT) {
+        throw std::out_of_range("Metric has no name");
+    }
+    return METRIC_NAMES[m];
+}
+
+bool parseMetric(std::string_view name, CostFunct::Metric& m) {
+    for(int i = 0; i < CostFunct::Metric::COUNT; i++) {
+        if(sameName(name, METRIC_NAMES[i])) {
+            m = CostFunct::Metric(i);
+            return true;
+        }
+    }
+    return false;
+}
+
 ///////////////
 // Constructor
 ///////////////
-CostFunct::CostFunct(){}
+CostFunct::CostFunct() 
+    : undirected_track(false) {}
 
 CostFunct::CostFunct(std::array<double, CostFunct::Metric::COUNT> ws) 
-    : weights(ws) {}
+    : weights(ws), undirected_track(false) {}
 
 CostFunct::CostFunct(std::map<Metric, double> ws) 
-    : weights() {
+    : weights(), undirected_track(false) {
     for(std::pair<Metric, double> w : ws)
         weights[w.first] = w.second;
 }
@@ -47,34 +72,80 @@ size_t CostFunct::getNumJunctions(const Network& net) const {
     return net.getNumJunctions();
 }
 
+size_t EdgeKeyHasher::operator()(const EdgeKey& key) const noexcept {
+    LocationHasher h;
+    return h(key.first) ^ (h(key.second) * 0x9E3779B97F4A7C15ull);
+}
+
+// O(f_r)
+template <typename Visit>
+void CostFunct::forEachEdge(const FactoryKey* stops, size_t n, Visit visit) const {
+    if(n == 0)
+        return;
+    // Factory "previous" to first fact is the last fact
+    FactoryKey prev_fk = stops[n - 1];
+    for(size_t i = 0; i < n; i++) {
+        visit(edgeKey(prev_fk, stops[i]));
+        prev_fk = stops[i];
+    }
+}
+
+template <typename Visit>
+void CostFunct::forEachEdge(const std::vector<FactoryKey>& stops, Visit visit) const {
+    forEachEdge(stops.data(), stops.size(), visit);
+}
+
+// edge tables are kept per thread and only cleared between evaluations,
+// so scoring a network doesn't allocate once the table has grown to fit
+static EdgeCounter& edgeScratch() {
+    static thread_local EdgeCounter counter;
+    return counter;
+}
+
+// the edges an edit takes out and puts in, kept per thread like edgeScratch
+// so scoring an edit doesn't allocate
+struct EditEdges {
+    EdgeCounter removed, added;
+};
+static EditEdges& editScratch() {
+    static thread_local EditEdges edges;
+    return edges;
+}
+
 // O(r * f_r)
+void CostFunct::countEdges(const Network& net, EdgeCounter& counter) const {
+    counter.clear();
+    for(Network::RouteIterator r_it = net.routeCBegin(); r_it != net.routeCEnd(); r_it++)
+        forEachEdge(r_it->stopKeys(), r_it->size(), [&counter](const EdgeKey& e) { counter.increment(e); });
+}
+
+// O(r * f_r + m log m), m distinct multiplicities
 std::map<size_t, Dist> CostFunct::getTrackLengthMap(const Network& net) const {
-    // map a unique pair of Locations to the number of Route using that connection
-    std::map<std::pair<FactoryKey, FactoryKey>, size_t> edge_mult_map;
-    
-    // fill edge map
-    // for each Route
-    for(size_t i = 0; i < net.getNumRoutes(); i++) {
-        Route r = net.getRoute(i);
-        // Factory "previous" to first fact is the last fact
-        FactoryKey prev_fk = (--r.cend())->first;
-        // for each fact
-        for(PairList<FactoryKey, ResourceList>::const_iterator fp_it = r.cbegin(); fp_it != r.cend(); fp_it++) {
-            // add edge
-            edge_mult_map[std::make_pair(prev_fk, fp_it->first)]++;
-            // update prev
-            prev_fk = fp_it->first;
-        }
-    }
+    EdgeCounter& edges = edgeScratch();
+    countEdges(net, edges);
 
-    // convert edge map to length map
+    // map the number of routes using an edge to the length of all such edges
     std::map<size_t, Dist> out;
-    for(std::pair<std::pair<FactoryKey, FactoryKey>, size_t> mp : edge_mult_map)
-        out[mp.second] += dist(mp.first.first, mp.first.second);
-    // return length map
+    edges.forEach([&out](const EdgeKey& e, uint32_t mult) {
+        out[mult] += dist(e.first, e.second);
+    });
     return out;
 }
 
+// O(r * f_r)
+void CostFunct::getTrackLengths(const Network& net, Dist& base_track, Dist& shared_track) const {
+    EdgeCounter& edges = edgeScratch();
+    countEdges(net, edges);
+
+    base_track = {0, 0};
+    shared_track = {0, 0};
+    edges.forEach([&](const EdgeKey& e, uint32_t mult) {
+        Dist d = dist(e.first, e.second);
+        base_track += d;
+        shared_track += (Dist){Coord(d.rat_*(mult - 1)), Coord(d.irrat_*(mult - 1))};
+    });
+}
+
 // O(r * f_r)
 Dist CostFunct::getMaxLength(const Network& net) const {
     // track best length
@@ -84,7 +155,7 @@ Dist CostFunct::getMaxLength(const Network& net) const {
         // get len
         Dist len = net.getRoute(i).getLength();
         // track best len
-        if(m.toDouble() < len.toDouble())
+        if(m < len)
             m = len;
     }
     // return best route
@@ -159,35 +230,277 @@ Quant CostFunct::getTotalPeakCapacity(const Network& net) const {
 }*/
 
 // O(r * f_r)
+std::array<double, CostFunct::Metric::COUNT> CostFunct::getMetricValues(const Network& net) const {
+    std::array<double, Metric::COUNT> values;
+    values[NumJunctions] = getNumJunctions(net);
+
+    // BaseTrackLength, SharedTrackLength
+    //   first route is charged at base rate
+    //   all additional routes apply a discount
+    Dist base_track, shared_track;
+    getTrackLengths(net, base_track, shared_track);
+    values[BaseTrackLength] = base_track.toDouble();
+    values[SharedTrackLength] = shared_track.toDouble();
+
+    values[MaxLength] = getMaxLength(net).toDouble();
+    values[NumRoutes] = getNumRoutes(net);
+    values[MaxCarryTime] = getMaxCarryTime(net);
+    values[TotalCarryTime] = getTotalCarryTime(net);
+    values[MaxPeakCapacity] = getMaxPeakCapacity(net);
+    values[TotalPeakCapacity] = getTotalPeakCapacity(net);
+    return values;
+}
+
 Cost CostFunct::operator()(const Network& net) const {
+    std::array<double, Metric::COUNT> values = getMetricValues(net);
     Cost c = 0;
-    // NumJunctions 
-    c += getNumJunctions(net) * weights[NumJunctions];
+    for (size_t m = 0; m < Metric::COUNT; m++) {
+        c += values[m] * weights[m];
+    }
+    return c;
+}
 
-    // BaseTrackLength, SharedTrackLength
-    std::map<size_t, Dist> sharing_record = getTrackLengthMap(net);
-    for (std::pair<size_t, Dist> sr : sharing_record)
-        // Cost(Dist, NumRoutes) = D * (BaseCost * (NR - 1)*(1 - Discount))
-        //   first route is charged at base rate
-        //   all additional routes apply a discount
-        c += sr.second.toDouble() * (weights[BaseTrackLength] + (sr.first - 1)*(weights[SharedTrackLength]));
-    
-    // MaxLength
-    c += getMaxLength(net).toDouble() * weights[MaxLength];
 
-    // NumRoutes
-    c += getNumRoutes(net) * weights[NumRoutes];
+/////////////////
+// Incremental Evaluation
+/////////////////
+
+// d scaled by n, components may go negative so only use as an addend
+static Dist scaleDist(const Dist& d, long n) {
+    return (Dist){Coord(d.rat_*n), Coord(d.irrat_*n)};
+}
+
+// largest value left in values once every value in removed is taken out
+// (one instance per entry), T() if nothing is left
+// O(k log k) for k removed values
+template <typename T>
+static T maxExcluding(const std::multiset<T>& values, std::vector<T> removed) {
+    // walk both from the largest value down, each removed value cancels one equal value
+    std::sort(removed.begin(), removed.end());
+    typename std::vector<T>::const_reverse_iterator r = removed.rbegin();
+    for(typename std::multiset<T>::const_reverse_iterator it = values.rbegin(); it != values.rend(); it++) {
+        while(r != removed.rend() && *it < *r)
+            r++;
+        if(r == removed.rend() || *r < *it)
+            return *it;
+        r++;
+    }
+    return T();
+}
+
+EdgeKey CostFunct::edgeKey(FactoryKey from, FactoryKey to) const {
+    // undirected edges are stored with the smaller Location first
+    if(undirected_track && to < from)
+        std::swap(from, to);
+    return std::make_pair(from, to);
+}
+
+// O(f_r)
+CostFunct::RouteMetrics CostFunct::getRouteMetrics(const Route& route) const {
+    RouteMetrics m;
+    m.stops.reserve(route.size());
+    for(Route::const_iterator it = route.cbegin(); it != route.cend(); it++)
+        m.stops.push_back(it->first);
+    m.length = route.getLength();
+    m.carry_time = route.getCarryTime();
+    m.peak_capacity = route.getPeakCapacity();
+    return m;
+}
+
+// O(r * f_r + r log r)
+CostFunct::CostCache CostFunct::buildCache(const Network& net) const {
+    CostCache cache;
+    cache.base_track = {0, 0};
+    cache.shared_track = {0, 0};
+    cache.total_carry_time = 0;
+    cache.total_peak_capacity = 0;
+    cache.num_junctions = getNumJunctions(net);
+
+    // metrics and edges of every route
+    for(Network::RouteIterator r_it = net.routeCBegin(); r_it != net.routeCEnd(); r_it++) {
+        cache.routes.push_back(getRouteMetrics(*r_it));
+        const RouteMetrics& m = cache.routes.back();
+        forEachEdge(m.stops, [&cache](const EdgeKey& e) { cache.edge_mult.increment(e); });
+        cache.lengths.insert(m.length);
+        cache.carry_times.insert(m.carry_time);
+        cache.peak_capacities.insert(m.peak_capacity);
+        cache.total_carry_time += m.carry_time;
+        cache.total_peak_capacity += m.peak_capacity;
+    }
+
+    // track totals
+    cache.edge_mult.forEach([&cache](const EdgeKey& e, uint32_t mult) {
+        Dist d = dist(e.first, e.second);
+        cache.base_track += d;
+        cache.shared_track += scaleDist(d, long(mult) - 1);
+    });
+    return cache;
+}
+
+// O(e * (f_r + log r))
+CostFunct::EditTotals CostFunct::evaluateEdit(const CostCache& cache, const NetworkEdit& edit, const std::vector<RouteMetrics>& new_metrics) const {
+    EditTotals t;
 
-    // NumRoutes
-    c += getMaxCarryTime(net) * weights[MaxCarryTime];
+    // routes leaving the network
+    std::vector<const RouteMetrics*> old_metrics;
+    for(const std::pair<RouteKey, Route>& rp : edit.replaced)
+        old_metrics.push_back(&cache.routes.at(rp.first));
+    for(RouteKey k : edit.erased)
+        old_metrics.push_back(&cache.routes.at(k));
 
-    // NumRoutes
-    c += getTotalCarryTime(net) * weights[TotalCarryTime];
+    // edges the edit takes out and puts in
+    EditEdges& edges = editScratch();
+    edges.removed.clear();
+    edges.added.clear();
+    for(const RouteMetrics* m : old_metrics)
+        forEachEdge(m->stops, [&edges](const EdgeKey& e) { edges.removed.increment(e); });
+    for(const RouteMetrics& m : new_metrics)
+        forEachEdge(m.stops, [&edges](const EdgeKey& e) { edges.added.increment(e); });
 
-    // NumRoutes
-    c += getMaxPeakCapacity(net) * weights[MaxPeakCapacity];
+    // BaseTrackLength, SharedTrackLength
+    //   an edge is billed at base rate once it is used,
+    //   and at the shared rate for every additional use
+    t.base_track = cache.base_track;
+    t.shared_track = cache.shared_track;
+    auto change = [&](const EdgeKey& e, long mult_change) {
+        if(mult_change == 0)
+            return;
+        long before = cache.edge_mult.count(e),
+             after = before + mult_change;
+        Dist d = dist(e.first, e.second);
+        t.base_track += scaleDist(d, (after > 0) - (before > 0));
+        t.shared_track += scaleDist(d, std::max(after - 1, 0L) - std::max(before - 1, 0L));
+    };
+    edges.removed.forEach([&](const EdgeKey& e, uint32_t n) { change(e, long(edges.added.count(e)) - long(n)); });
+    edges.added.forEach([&](const EdgeKey& e, uint32_t n) {
+        if(edges.removed.count(e) == 0)
+            change(e, n);
+    });
+
+    // per route metrics
+    std::vector<Dist> old_lengths;
+    std::vector<double> old_carry_times;
+    std::vector<Quant> old_peak_capacities;
+    t.total_carry_time = cache.total_carry_time;
+    t.total_peak_capacity = cache.total_peak_capacity;
+    for(const RouteMetrics* m : old_metrics) {
+        old_lengths.push_back(m->length);
+        old_carry_times.push_back(m->carry_time);
+        old_peak_capacities.push_back(m->peak_capacity);
+        t.total_carry_time -= m->carry_time;
+        t.total_peak_capacity -= m->peak_capacity;
+    }
+    t.max_length = maxExcluding(cache.lengths, old_lengths);
+    t.max_carry_time = maxExcluding(cache.carry_times, old_carry_times);
+    t.max_peak_capacity = maxExcluding(cache.peak_capacities, old_peak_capacities);
+    for(const RouteMetrics& m : new_metrics) {
+        if(t.max_length < m.length)
+            t.max_length = m.length;
+        t.max_carry_time = std::max(t.max_carry_time, m.carry_time);
+        t.max_peak_capacity = std::max(t.max_peak_capacity, m.peak_capacity);
+        t.total_carry_time += m.carry_time;
+        t.total_peak_capacity += m.peak_capacity;
+    }
+
+    t.num_routes = cache.routes.size() - edit.erased.size() + edit.added.size();
+    t.num_junctions = cache.num_junctions;
+    return t;
+}
 
-    // NumRoutes
-    c += getTotalPeakCapacity(net) * weights[TotalPeakCapacity];
+// O(1)
+Cost CostFunct::totalsCost(const EditTotals& t) const {
+    Cost c = 0;
+    c += t.num_junctions * weights[NumJunctions];
+    c += t.base_track.toDouble() * weights[BaseTrackLength];
+    c += t.shared_track.toDouble() * weights[SharedTrackLength];
+    c += t.max_length.toDouble() * weights[MaxLength];
+    c += t.num_routes * weights[NumRoutes];
+    c += t.max_carry_time * weights[MaxCarryTime];
+    c += t.total_carry_time * weights[TotalCarryTime];
+    c += t.max_peak_capacity * weights[MaxPeakCapacity];
+    c += t.total_peak_capacity * weights[TotalPeakCapacity];
     return c;
 }
+
+// O(1)
+Cost CostFunct::operator()(const CostCache& cache) const {
+    EditTotals t;
+    t.base_track = cache.base_track;
+    t.shared_track = cache.shared_track;
+    t.max_length = cache.lengths.empty() ? (Dist){0, 0} : *cache.lengths.rbegin();
+    t.max_carry_time = cache.carry_times.empty() ? 0 : *cache.carry_times.rbegin();
+    t.total_carry_time = cache.total_carry_time;
+    t.max_peak_capacity = cache.peak_capacities.empty() ? 0 : *cache.peak_capacities.rbegin();
+    t.total_peak_capacity = cache.total_peak_capacity;
+    t.num_routes = cache.routes.size();
+    t.num_junctions = cache.num_junctions;
+    return totalsCost(t);
+}
+
+// O(e * (f_r + log r))
+Cost CostFunct::delta(const CostCache& cache, const NetworkEdit& edit) const {
+    std::vector<RouteMetrics> new_metrics;
+    for(const std::pair<RouteKey, Route>& rp : edit.replaced)
+        new_metrics.push_back(getRouteMetrics(rp.second));
+    for(const Route& r : edit.added)
+        new_metrics.push_back(getRouteMetrics(r));
+    return totalsCost(evaluateEdit(cache, edit, new_metrics)) - operator()(cache);
+}
+
+// O(e * (f_r + log r) + r)
+//   erasing from the middle of the route metrics and summing the carry times are linear in r
+Cost CostFunct::apply(CostCache& cache, const NetworkEdit& edit) const {
+    std::vector<RouteMetrics> new_metrics;
+    for(const std::pair<RouteKey, Route>& rp : edit.replaced)
+        new_metrics.push_back(getRouteMetrics(rp.second));
+    for(const Route& r : edit.added)
+        new_metrics.push_back(getRouteMetrics(r));
+    EditTotals t = evaluateEdit(cache, edit, new_metrics);
+
+    // take a route's edges and metrics out of the cache
+    auto remove = [&](const RouteMetrics& m) {
+        forEachEdge(m.stops, [&cache](const EdgeKey& e) { cache.edge_mult.subtract(e, 1); });
+        cache.lengths.erase(cache.lengths.find(m.length));
+        cache.carry_times.erase(cache.carry_times.find(m.carry_time));
+        cache.peak_capacities.erase(cache.peak_capacities.find(m.peak_capacity));
+    };
+    // put a route's edges and metrics into the cache
+    auto insert = [&](const RouteMetrics& m) {
+        forEachEdge(m.stops, [&cache](const EdgeKey& e) { cache.edge_mult.increment(e); });
+        cache.lengths.insert(m.length);
+        cache.carry_times.insert(m.carry_time);
+        cache.peak_capacities.insert(m.peak_capacity);
+    };
+
+    // replace in place
+    size_t m_i = 0;
+    for(const std::pair<RouteKey, Route>& rp : edit.replaced) {
+        remove(cache.routes[rp.first]);
+        cache.routes[rp.first] = new_metrics[m_i++];
+        insert(cache.routes[rp.first]);
+    }
+    // erase, from the back so keys stay valid
+    std::vector<RouteKey> erased(edit.erased);
+    std::sort(erased.begin(), erased.end(), std::greater<RouteKey>());
+    for(RouteKey k : erased) {
+        remove(cache.routes[k]);
+        cache.routes.erase(cache.routes.begin() + k);
+    }
+    // append
+    for(; m_i < new_metrics.size(); m_i++) {
+        cache.routes.push_back(new_metrics[m_i]);
+        insert(cache.routes.back());
+    }
+
+    // totals
+    cache.base_track = t.base_track;
+    cache.shared_track = t.shared_track;
+    cache.total_peak_capacity = t.total_peak_capacity;
+    // summed again in route order rather than kept with += and -=, which
+    // drifts over a long polish. Now the total is the one getTotalCarryTime gives
+    cache.total_carry_time = 0;
+    for(const RouteMetrics& m : cache.routes)
+        cache.total_carry_time += m.carry_time;
+    t.total_carry_time = cache.total_carry_time;
+    return totalsCost(t);
+}
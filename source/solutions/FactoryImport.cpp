@@ -0,0 +1,364 @@
+/*
+FactoryImport definitions
+
+Definitions for the FactoryImporter class.
+*/
+
+/////////////////
+// Includes
+/////////////////
+
+#include "../../headers/solutions/FactoryImport.h"
+#include "../../headers/solutions/Constraints.h"
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+/////////////////
+// Helpers
+/////////////////
+
+// Factorio item names for each resource, for names parseResource doesn't know
+static const std::pair<const char*, Resource> ITEM_NAMES[] = {
+    {"copper-plate", Resource::Copper},
+    {"steel-plate", Resource::Steel},
+    {"iron-plate", Resource::Iron},
+    {"uranium-235", Resource::Uranium},
+    {"uranium-ore", Resource::Uranium},
+    {"electronic-circuit", Resource::Circuits},
+    {"raw-fish", Resource::Fish},
+    {"copper-cable", Resource::Wire},
+    {"engine-unit", Resource::Engine},
+    {"iron-gear-wheel", Resource::Gear}
+};
+
+static std::string_view trim(std::string_view s)
+{
+    while (!s.empty() && std::isspace(static_cast<unsigned char>(s.front()))) {s.remove_prefix(1);}
+    while (!s.empty() && std::isspace(static_cast<unsigned char>(s.back()))) {s.remove_suffix(1);}
+    return s;
+}
+
+// the whole of s as an int32, false if it isn't one or doesn't fit
+static bool parseInt(std::string_view s, int32_t& value)
+{
+    s = trim(s);
+    std::from_chars_result result = std::from_chars(s.data(), s.data() + s.size(), value);
+    return !s.empty() && result.ec == std::errc() && result.ptr == s.data() + s.size();
+}
+
+// splits off the text before the next comma, s keeps the rest
+static std::string_view nextField(std::string_view& s)
+{
+    size_t comma = s.find(',');
+    std::string_view field = s.substr(0, comma);
+    s = comma == std::string_view::npos ? std::string_view() : s.substr(comma + 1);
+    return trim(field);
+}
+
+/////////////////
+// JsonScanner
+/////////////////
+
+// Just enough JSON for a flat object of numbers and strings, with
+// one nested object of numbers. Strings can't have escapes.
+struct JsonScanner {
+    std::string_view s;
+    size_t pos;
+    const char* error;
+
+    void skipSpace()
+    {
+        while (pos < s.size() && std::isspace(static_cast<unsigned char>(s[pos]))) {pos++;}
+    }
+
+    // skips whitespace and then c, false if the next thing isn't c
+    bool take(char c)
+    {
+        skipSpace();
+        if (pos < s.size() && s[pos] == c)
+        {
+            pos++;
+            return true;
+        }
+        return false;
+    }
+
+    bool peek(char c)
+    {
+        skipSpace();
+        return pos < s.size() && s[pos] == c;
+    }
+
+    bool string(std::string_view& out)
+    {
+        if (!take('"')) {error = "expected a string"; return false;}
+        size_t end = s.find('"', pos);
+        if (end == std::string_view::npos) {error = "unterminated string"; return false;}
+        out = s.substr(pos, end - pos);
+        if (out.find('\\') != std::string_view::npos) {error = "escapes in strings aren't supported"; return false;}
+        pos = end + 1;
+        return true;
+    }
+
+    // the text of a number, checked when it is converted
+    bool number(std::string_view& out)
+    {
+        skipSpace();
+        size_t start = pos;
+        while (pos < s.size() && (std::isalnum(static_cast<unsigned char>(s[pos])) || s[pos] == '-' || s[pos] == '+' || s[pos] == '.')) {pos++;}
+        if (pos == start) {error = "expected a number"; return false;}
+        out = s.substr(start, pos - start);
+        return true;
+    }
+
+    // a string, number, true, false or null
+    bool skipValue()
+    {
+        std::string_view ignored;
+        return peek('"') ? string(ignored) : number(ignored);
+    }
+};
+
+/////////////////
+// Constructors
+/////////////////
+
+FactoryImporter::FactoryImporter() :
+    num_lines_(0),
+    num_rows_(0)
+{}
+
+/////////////////
+// Functions
+/////////////////
+
+void FactoryImporter::fail(const std::string& what) const
+{
+    throw std::invalid_argument("factory file line " + std::to_string(num_lines_) + ": " + what);
+}
+
+// O(chunk)
+void FactoryImporter::feed(const char* data, size_t size)
+{
+    const char* end = data + size;
+    const char* newline = static_cast<const char*>(std::memchr(data, '\n', size));
+    // finish the line the last chunk cut off
+    if (!partial_.empty())
+    {
+        if (!newline)
+        {
+            partial_.append(data, size);
+            return;
+        }
+        partial_.append(data, newline);
+        parseLine(partial_.data(), partial_.data() + partial_.size());
+        partial_.clear();
+        data = newline + 1;
+        newline = static_cast<const char*>(std::memchr(data, '\n', end - data));
+    }
+    // whole lines are parsed where they are
+    while (newline)
+    {
+        parseLine(data, newline);
+        data = newline + 1;
+        newline = static_cast<const char*>(std::memchr(data, '\n', end - data));
+    }
+    partial_.assign(data, end);
+}
+
+void FactoryImporter::finish()
+{
+    if (partial_.empty()) {return;}
+    parseLine(partial_.data(), partial_.data() + partial_.size());
+    partial_.clear();
+}
+
+void FactoryImporter::read(std::istream& in, size_t chunk_bytes)
+{
+    std::vector<char> chunk(std::max<size_t>(chunk_bytes, 1));
+    while (in.read(chunk.data(), chunk.size()) || in.gcount() > 0)
+    {
+        feed(chunk.data(), in.gcount());
+    }
+    if (in.bad()) {throw std::runtime_error("can't read factory file");}
+    finish();
+}
+
+void FactoryImporter::readFile(const std::string& path, size_t chunk_bytes)
+{
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {throw std::runtime_error("can't open factory file: " + path);}
+    read(in, chunk_bytes);
+}
+
+void FactoryImporter::parseLine(const char* begin, const char* end)
+{
+    num_lines_++;
+    std::string_view line = trim(std::string_view(begin, end - begin));
+    if (line.empty() || line.front() == '#') {return;}
+    if (line.front() == '{') {parseJson(line);}
+    else {parseCsv(line);}
+}
+
+void FactoryImporter::parseCsv(std::string_view line)
+{
+    std::string_view rest = line;
+    std::string_view x = nextField(rest), y = nextField(rest);
+    Location loc;
+    if (!parseInt(x, loc.x) || !parseInt(y, loc.y))
+    {
+        // a header is only allowed before the first row
+        if (num_rows_ == 0 && !x.empty() && !std::isdigit(static_cast<unsigned char>(x.back()))) {return;}
+        fail("expected x,y coordinates");
+    }
+    ResourceList quants;
+    while (!rest.empty())
+    {
+        std::string_view name = nextField(rest);
+        if (rest.empty()) {fail("resource '" + std::string(name) + "' has no quant");}
+        addQuant(quants, name, nextField(rest));
+    }
+    addRow(loc, quants);
+}
+
+void FactoryImporter::parseJson(std::string_view line)
+{
+    JsonScanner json{line, 0, nullptr};
+    Location loc;
+    bool has_x = false, has_y = false;
+    ResourceList quants;
+    json.take('{');
+    for (bool first = true; !json.take('}'); first = false)
+    {
+        std::string_view key, value;
+        if ((!first && !json.take(',')) || !json.string(key) || !json.take(':'))
+        {
+            fail(json.error ? json.error : "expected \"key\": value");
+        }
+        if (key == "x" || key == "y")
+        {
+            if (!json.number(value)) {fail(json.error);}
+            if (!parseInt(value, key == "x" ? loc.x : loc.y)) {fail("expected an integer coordinate");}
+            (key == "x" ? has_x : has_y) = true;
+        }
+        else if (key == "resources" || key == "items")
+        {
+            if (!json.take('{')) {fail("expected an object of resources");}
+            for (bool first_item = true; !json.take('}'); first_item = false)
+            {
+                std::string_view name;
+                if ((!first_item && !json.take(',')) || !json.string(name) || !json.take(':') || !json.number(value))
+                {
+                    fail(json.error ? json.error : "expected \"resource\": quant");
+                }
+                addQuant(quants, name, value);
+            }
+        }
+        else if (!json.skipValue())
+        {
+            fail(json.error);
+        }
+    }
+    json.skipSpace();
+    if (json.pos != line.size()) {fail("text after the end of the object");}
+    if (!has_x || !has_y) {fail("expected \"x\" and \"y\"");}
+    addRow(loc, quants);
+}
+
+void FactoryImporter::addQuant(ResourceList& quants, std::string_view name, std::string_view quant) const
+{
+    Resource r;
+    bool known = parseResource(name, r);
+    for (size_t i = 0; !known && i < sizeof(ITEM_NAMES) / sizeof(ITEM_NAMES[0]); i++)
+    {
+        // items of resources a small catalogue leaves out are unknown
+        if (ITEM_NAMES[i].second >= Resource::COUNT || !sameName(name, ITEM_NAMES[i].first)) {continue;}
+        r = ITEM_NAMES[i].second;
+        known = true;
+    }
+    if (!known) {fail("unknown resource '" + std::string(name) + "'");}
+    int32_t q;
+    if (!parseInt(quant, q)) {fail("expected an integer quant for '" + std::string(name) + "'");}
+    int64_t sum = int64_t(quants[r]) + q;
+    if (sum != Quant(sum)) {fail("quant of '" + std::string(name) + "' overflows");}
+    quants[r] = Quant(sum);
+}
+
+// spreads LocationHasher over an index with a power of 2 size, like Network does
+static size_t indexSlot(const Location& key, size_t mask)
+{
+    return (uint64_t(LocationHasher()(key)) * 0x9E3779B97F4A7C15ull >> 32) & mask;
+}
+
+// O(f)
+void FactoryImporter::growIndex()
+{
+    index_.assign(std::max<size_t>(16, 2 * index_.size()), 0);
+    size_t mask = index_.size() - 1;
+    for (size_t i = 0; i < locs_.size(); i++)
+    {
+        size_t slot = indexSlot(locs_[i], mask);
+        while (index_[slot] != 0) {slot = (slot + 1) & mask;}
+        index_[slot] = i + 1;
+    }
+}
+
+// O(R) expected
+void FactoryImporter::addRow(Location loc, const ResourceList& quants)
+{
+    num_rows_++;
+    if (2 * (locs_.size() + 1) > index_.size()) {growIndex();}
+    size_t mask = index_.size() - 1, slot = indexSlot(loc, mask);
+    while (index_[slot] != 0 && !(locs_[index_[slot] - 1] == loc)) {slot = (slot + 1) & mask;}
+    if (index_[slot] == 0)
+    {
+        index_[slot] = locs_.size() + 1;
+        locs_.push_back(loc);
+        quants_.push_back(quants);
+        return;
+    }
+    // another row for the same place
+    ResourceList& merged = quants_[index_[slot] - 1];
+    for (size_t r = 0; r < Resource::COUNT; r++)
+    {
+        int64_t sum = int64_t(merged[r]) + quants[r];
+        if (sum != Quant(sum)) {fail("quants at this Location overflow");}
+        merged[r] = Quant(sum);
+    }
+}
+
+size_t FactoryImporter::getNumLines() const
+{
+    return num_lines_;
+}
+
+size_t FactoryImporter::getNumRows() const
+{
+    return num_rows_;
+}
+
+size_t FactoryImporter::getNumPlaces() const
+{
+    return locs_.size();
+}
+
+Network FactoryImporter::toNetwork(bool validate) const
+{
+    Network net(locs_.data(), quants_.data(), locs_.size());
+    if (validate && !Constraints().isValidNetwork(net))
+    {
+        throw std::invalid_argument("imported factories don't make a valid network");
+    }
+    return net;
+}
+
+Network importFactories(const std::string& path, bool validate)
+{
+    FactoryImporter importer;
+    importer.readFile(path);
+    return importer.toNetwork(validate);
+}
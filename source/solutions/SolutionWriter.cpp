@@ -0,0 +1,194 @@
+/*
+SolutionWriter definitions
+
+Definitions for the SolutionWriter class.
+*/
+
+/////////////////
+// Includes
+/////////////////
+
+#include "../../headers/solutions/SolutionWriter.h"
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+#include <type_traits>
+
+static_assert(std::is_trivially_copyable<ResourceList>::value && sizeof(ResourceList) == Resource::COUNT * sizeof(Quant),
+    "commands are stored as they are in memory");
+#if defined(__BYTE_ORDER__)
+static_assert(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__, "solution files are little endian");
+#endif
+
+/////////////////
+// Helpers
+/////////////////
+
+// shortest text that reads back as the same double, null if it isn't finite
+static void writeNumber(std::ostream& out, double value)
+{
+    if (!std::isfinite(value))
+    {
+        out << "null";
+        return;
+    }
+    char text[32];
+    std::to_chars_result result = std::to_chars(text, text + sizeof(text), value);
+    out.write(text, result.ptr - text);
+}
+
+static void writeNumber(std::ostream& out, int64_t value)
+{
+    char text[24];
+    std::to_chars_result result = std::to_chars(text, text + sizeof(text), value);
+    out.write(text, result.ptr - text);
+}
+
+// the nonzero resources of rl as a JSON object
+static void writeCommand(std::ostream& out, const ResourceList& rl)
+{
+    out << '{';
+    bool first = true;
+    for (size_t r = 0; r < Resource::COUNT; r++)
+    {
+        if (rl[r] == 0) {continue;}
+        if (!first) {out << ',';}
+        out << '"' << resourceName(Resource(r)) << "\":";
+        writeNumber(out, int64_t(rl[r]));
+        first = false;
+    }
+    out << '}';
+}
+
+/////////////////
+// Constructors
+/////////////////
+
+SolutionWriter::SolutionWriter(const std::string& path, Format format) :
+    buffer_(size_t(64) << 10),
+    format_(format),
+    num_routes_(0)
+{
+    // the buffer has to be set before the file is opened to take effect
+    out_.rdbuf()->pubsetbuf(buffer_.data(), buffer_.size());
+    out_.open(path, std::ios::binary | std::ios::trunc);
+    if (!out_) {throw std::runtime_error("can't open solution file for writing: " + path);}
+
+    if (format_ == BINARY)
+    {
+        SolutionFileHeader header;
+        std::memcpy(header.magic, SolutionFile::MAGIC, sizeof(header.magic));
+        header.version = SolutionFile::VERSION;
+        header.num_resources = Resource::COUNT;
+        writeBytes(&header, sizeof(header));
+    }
+}
+
+/////////////////
+// Functions
+/////////////////
+
+void SolutionWriter::writeBytes(const void* bytes, size_t size)
+{
+    out_.write(static_cast<const char*>(bytes), size);
+}
+
+void SolutionWriter::writeRoute(RouteKey key, const Route& route)
+{
+    Dist length = route.getLength();
+    if (format_ == BINARY)
+    {
+        SolutionRecordHeader record = {SolutionFile::ROUTE, uint32_t(route.size())};
+        SolutionRouteRecord metrics = {key, length.rat_, length.irrat_, route.getPeakCapacity(), route.getCarryTime()};
+        writeBytes(&record, sizeof(record));
+        writeBytes(&metrics, sizeof(metrics));
+        writeBytes(route.stopKeys(), route.size() * sizeof(FactoryKey));
+        writeBytes(route.stopCommands(), route.size() * sizeof(ResourceList));
+    }
+    else
+    {
+        out_ << "{\"type\":\"route\",\"route\":";
+        writeNumber(out_, int64_t(key));
+        out_ << ",\"length\":";
+        writeNumber(out_, length.toDouble());
+        out_ << ",\"carry_time\":";
+        writeNumber(out_, route.getCarryTime());
+        out_ << ",\"peak_capacity\":";
+        writeNumber(out_, int64_t(route.getPeakCapacity()));
+        out_ << ",\"stops\":[";
+        const FactoryKey* keys = route.stopKeys();
+        const ResourceList* commands = route.stopCommands();
+        for (size_t i = 0; i < route.size(); i++)
+        {
+            if (i > 0) {out_ << ',';}
+            out_ << "{\"x\":";
+            writeNumber(out_, int64_t(keys[i].x));
+            out_ << ",\"y\":";
+            writeNumber(out_, int64_t(keys[i].y));
+            out_ << ",\"command\":";
+            writeCommand(out_, commands[i]);
+            out_ << '}';
+        }
+        out_ << "]}\n";
+    }
+    num_routes_++;
+}
+
+void SolutionWriter::writeCost(const CostFunct& cost, const Network& net)
+{
+    std::array<double, CostFunct::Metric::COUNT> values = cost.getMetricValues(net);
+    Cost total = cost(net);
+    if (format_ == BINARY)
+    {
+        SolutionRecordHeader record = {SolutionFile::COST, uint32_t(CostFunct::Metric::COUNT)};
+        writeBytes(&record, sizeof(record));
+        writeBytes(&total, sizeof(total));
+        for (size_t m = 0; m < CostFunct::Metric::COUNT; m++)
+        {
+            SolutionMetricRecord metric = {values[m], cost.weights[m]};
+            writeBytes(&metric, sizeof(metric));
+        }
+    }
+    else
+    {
+        out_ << "{\"type\":\"cost\",\"cost\":";
+        writeNumber(out_, total);
+        out_ << ",\"metrics\":{";
+        for (CostFunct::Metric m = CostFunct::Metric(0); m < CostFunct::Metric::COUNT; m++)
+        {
+            if (m > 0) {out_ << ',';}
+            out_ << '"' << metricName(m) << "\":{\"value\":";
+            writeNumber(out_, values[m]);
+            out_ << ",\"weight\":";
+            writeNumber(out_, cost.weights[m]);
+            out_ << ",\"cost\":";
+            writeNumber(out_, values[m] * cost.weights[m]);
+            out_ << '}';
+        }
+        out_ << "}}\n";
+    }
+}
+
+void SolutionWriter::close()
+{
+    out_.close();
+    if (!out_) {throw std::runtime_error("can't write solution file");}
+}
+
+size_t SolutionWriter::getNumRoutes() const
+{
+    return num_routes_;
+}
+
+// O(r * s * R)
+void writeSolution(const Network& net, const CostFunct& cost, const std::string& path, SolutionWriter::Format format)
+{
+    SolutionWriter writer(path, format);
+    writer.writeCost(cost, net);
+    for (RouteKey key = 0; key < net.getNumRoutes(); key++)
+    {
+        writer.writeRoute(key, net.getRoute(key));
+    }
+    writer.close();
+}
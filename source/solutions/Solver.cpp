@@ -10,15 +10,20 @@ Definitions for the Solver class.
 // Includes
 /////////////////
 #include "../../headers/solutions/Solver.h"
+#include "../../headers/data/SpatialIndex.h"
+#include "../../headers/data/HashCounter.h"
+#include "../../headers/solutions/ThreadPool.h"
 #include <queue>
 #include <algorithm>
+#include <assert.h>
 
 
 /////////////////
 // Functions
 /////////////////
 Solver::Solver(const Network& net, const CostFunct cos, const Constraints constr)
-    : network(net), cost(cos), constraints(constr) {}
+    : network(net), cost(cos), constraints(constr), num_threads(1), seed(std::mt19937::default_seed),
+      memory_upstream(std::pmr::new_delete_resource()), edge_k(0), edge_radius{0, 0} {}
 
 bool Solver::canSolve() const {
     return constraints.isValidNetwork(network);
@@ -36,94 +41,120 @@ bool Solver::passesConstraints() const {
 // Junction function
 /////////////////////////////////////////
 
-void inline increment(std::map<Location, int>& map, Location key)
+typedef HashCounter<Location, LocationHasher> JunctionCounter;
+
+// counts the candidate junction points between factories at a and b
+// a pair makes between 2 and 6 of them
+static void addJunctionCandidates(JunctionCounter& locations, Location a, Location b)
 {
-    std::map<Location, int>::iterator iterator = map.find(key);
-    if (iterator == map.end())
+    // grab and decouple the Locations of a and b
+    Coord aX = a.x, aY = a.y;
+    Coord bX = b.x, bY = b.y;
+    Location octant = b - a;
+    // calculate the intersections of the lines and add them to the locations vector, these are good points for junctions.
+
+    if (octant.x != 0 and octant.y != 0) // check colinearity for streights
     {
-        map.insert(std::pair<Location, int>(key, 1));
+        locations.increment(Location(aX,bY)); // Locations for the first hanan map
+        locations.increment(Location(bX,aY));
     }
-    else
+    // check parity of the Locations. If this value is 0, then the intersection of the diagonal lines will be on integer coordinates and a valid point in our space
+    // we also check colinearity on diagonals
+    if((aX+bX+aY+bY)%2 == 0 and ((abs(octant.x) - abs(octant.y)) != 0))
     {
-        iterator->second++;
+        locations.increment(Location((aX+aY+bX-bY)/2, (aX+aY-bX+bY)/2)); // locations for the diagonal intersections
+        locations.increment(Location((aX-aY+bX+bY)/2, (-aX+aY+bX+bY)/2));
     }
+    // intersections of steight lines and diagonal lines. these only are valid if the points are in specific octants of each other
+    short truth = (signof<Coord>(octant.x) == signof<Coord>(octant.y))*10 + (abs(octant.x) > abs(octant.y));
+    switch (truth)
+    {
+    case 11: // first/fifth octant
+        locations.increment(Location(bX+aY-bY, aY));
+        locations.increment(Location(aX+bY-aY, bY));
+        break;
+    case 10: // second/sixth octant
+        locations.increment(Location(aX, bY+aX-bX));
+        locations.increment(Location(bX, aY+bX-aX));
+        break;
+    case 0: // third/seventh octant
+        locations.increment(Location(aX, bY-aX+bX));
+        locations.increment(Location(bX, aY-bX+aX));
+        break;
+    case 1: // fourth/eighth octant
+        locations.increment(Location(bX-aY+bY, aY));
+        locations.increment(Location(aX-bY+aY, bY));
+        break;
+    default:
+        throw std::out_of_range("Invalid Octant in JunctionFunciton, Something evil this way comes.");
+        break;
+    } // switch
 }
 
-std::vector<std::pair<Location, int>> Solver::junctionFunction(size_t numberJunctions)
+// O(f^2 + c + n log n) for every pair, O(f * (k + log f) + c + n log n) with a radius,
+//   k factories within the radius, c candidate points, n numberJunctions
+//   the pair loop runs on num_threads threads
+std::vector<std::pair<Location, int>> Solver::junctionFunction(size_t numberJunctions, Dist radius)
 {
-    std::map<Location, int> locations;
-
-    // iterate over each pair of factories in the network
-    for (auto a = network.factCBegin(); a!= network.factCEnd(); a++)
+    // only factories make junction points, not junctions
+    std::vector<Location> facts;
+    for (FactoryId id : network.getPlaceIds())
     {
-        // check that a is a factroy
-        if (a->second.getBaseQuants() == ResourceList()) continue;
-        auto b = a;
-        b++;
-        while(b != network.factCEnd())
-        {
-            if (b->second.getBaseQuants() == ResourceList()) continue;
-
-            // grab and decouple the Locations of a and b
-            Coord aX = a->first.x, aY = a->first.y;
-            Coord bX = b->first.x, bY = b->first.y;
-            Location octant = b->first - a->first;
-            // calculate the intersections of the lines and add them to the locations vector, these are good points for junctions.
+        if (!(network.getPlaceBaseQuants(id) == ResourceList())) facts.push_back(network.getPlaceLoc(id));
+    }
 
-            if (octant.x != 0 and octant.y != 0) // check colinearity for streights
+    // shard the outer loop over the threads. Shard s takes every a with a % shards == s,
+    // which evens out the shrinking inner loop. Each shard counts into its own table,
+    // the tables are summed afterwards, and the final ordering doesn't depend on
+    // the order they are summed in, so the output is the same for any number of threads.
+    ThreadPool pool(num_threads);
+    const size_t shards = pool.size() == 1 ? 1 : pool.size() * 4;
+    std::vector<JunctionCounter> counts(shards, JunctionCounter(facts.size() * 8 / shards));
+    SpatialIndex index;
+    if (!(radius == Dist{0, 0})) {index = SpatialIndex(facts);}
+    pool.parallelFor(shards, [&](size_t s) {
+        JunctionCounter& shard = counts[s];
+        for (size_t a = s; a < facts.size(); a += shards)
+        {
+            if (radius == Dist{0, 0})
             {
-                increment(locations, Location(aX,bY)); // Locations for the first hanan map
-                increment(locations, Location(bX,aY));
+                // iterate over each pair of factories in the network
+                for (size_t b = a + 1; b < facts.size(); b++)
+                    addJunctionCandidates(shard, facts[a], facts[b]);
             }
-            // check parity of the Locations. If this value is 0, then the intersection of the diagonal lines will be on integer coordinates and a valid point in our space
-            // we also check colinearity on diagonals
-            if((aX+bX+aY+bY)%2 == 0 and ((abs(octant.x) - abs(octant.y)) != 0))
+            else
             {
-                increment(locations, Location((aX+aY+bX-bY)/2, (aX+aY-bX+bY)/2)); // locations for the diagonal intersections
-                increment(locations, Location((aX-aY+bX+bY)/2, (-aX+aY+bX+bY)/2));
+                // only pairs of nearby factories
+                for (size_t b : index.withinRadius(facts[a], radius))
+                    if (b > a) addJunctionCandidates(shard, facts[a], facts[b]);
             }
-            // intersections of steight lines and diagonal lines. these only are valid if the points are in specific octants of each other
-            short truth = (signof<Coord>(octant.x) == signof<Coord>(octant.y))*10 + (abs(octant.x) > abs(octant.y));
-            switch (truth)
-            {
-            case 11: // first/fifth octant
-                increment(locations, Location(bX+aY-bY, aY));
-                increment(locations, Location(aX+bY-aY, bY));
-                break;
-            case 10: // second/sixth octant
-                increment(locations, Location(aX, bY+aX-bX));
-                increment(locations, Location(bX, aY+bX-aX));
-                break;
-            case 0: // third/seventh octant
-                increment(locations, Location(aX, bY-aX+bX));
-                increment(locations, Location(bX, aY-bX+aX));
-                break;
-            case 1: // fourth/eighth octant
-                increment(locations, Location(bX-aY+bY, aY));
-                increment(locations, Location(aX-bY+aY, bY));
-                break;
-            default:
-                throw std::out_of_range("Invalid Octant in JunctionFunciton, Something evil this way comes.");
-                break;
-            } // switch
-            b++;
-        }// while
-    }// for
-
-    // so now all of the junction points have been found and their multiplicity counted. Now to sort them and prep them for output.
-    std::vector<std::pair<Location, int>> output;
-    output.reserve(locations.size());
-    for (auto i = locations.begin(); i != locations.end(); i++)
+        }
+    });
+    JunctionCounter& locations = counts[0];
+    for (size_t s = 1; s < shards; s++)
     {
-        if (!network.hasPlace(i->first)) output.push_back(*i); // I didn't put squiggles just for you Ethan.
+        locations.merge(counts[s]);
     }
-    // sort the output vector, first by multiplicity then by location.
-    // cite sources: https://stackoverflow.com/questions/279854/how-do-i-sort-a-vector-of-pairs-based-on-the-second-element-of-the-pair
-    std::sort(output.begin(), output.end(), [](const std::pair<Location, int> &left, const std::pair<Location, int> &right) 
+
+    // so now all of the junction points have been found and their multiplicity counted. Now to pick the best and prep them for output.
+    std::vector<std::pair<Location, int>> output;
+    output.reserve(locations.size());
+    locations.forEach([&](const Location& loc, uint32_t count) {
+        if (!network.hasPlace(loc)) output.emplace_back(loc, count); // I didn't put squiggles just for you Ethan.
+    });
+    // order first by multiplicity then by location.
+    auto better = [](const std::pair<Location, int> &left, const std::pair<Location, int> &right) 
     {
         if (left.second != right.second) return left.second > right.second;
         else return left.first > right.first;
-    });
+    };
+    // only the best numberJunctions need sorting
+    if (output.size() > numberJunctions)
+    {
+        std::nth_element(output.begin(), output.begin() + numberJunctions, output.end(), better);
+        output.resize(numberJunctions);
+    }
+    std::sort(output.begin(), output.end(), better);
 
     output.resize(numberJunctions);
     return output;
@@ -133,3 +164,234 @@ const Network& Solver::getNet() const {
     return network;
 }
 
+
+
+/////////////////////////////////////////
+// Memory
+/////////////////////////////////////////
+
+// the resource scratch() returns on this thread, nullptr for the default one
+static thread_local std::pmr::memory_resource* scratch_resource = nullptr;
+
+std::pmr::memory_resource* Solver::scratch() {
+    return scratch_resource ? scratch_resource : std::pmr::get_default_resource();
+}
+
+Solver::ScratchScope::ScratchScope(std::pmr::memory_resource* mem) : prev(scratch_resource) {
+    scratch_resource = mem;
+}
+Solver::ScratchScope::~ScratchScope() {
+    scratch_resource = prev;
+}
+
+void Solver::resetArenas(size_t n) {
+    for(std::unique_ptr<ArenaResource>& arena : arenas) {
+        memory_stats += arena->takeStats();
+        arena->reset();
+    }
+    while(arenas.size() < n)
+        arenas.push_back(std::unique_ptr<ArenaResource>(new ArenaResource(memory_upstream)));
+}
+
+void Solver::setMemoryResource(std::pmr::memory_resource* upstream) {
+    arenas.clear();
+    memory_upstream = upstream;
+}
+const MemoryStats& Solver::getMemoryStats() const {
+    return memory_stats;
+}
+
+
+/////////////////////////////////////////
+// Threading and randomness
+/////////////////////////////////////////
+
+void Solver::setThreads(size_t n) {
+    num_threads = n;
+}
+size_t Solver::getThreads() const {
+    return num_threads;
+}
+void Solver::setSeed(uint64_t s) {
+    seed = s;
+}
+uint64_t Solver::getSeed() const {
+    return seed;
+}
+
+std::mt19937& Solver::rng() {
+    // every thread gets its own stream, so no locking is needed
+    thread_local std::mt19937 engine;
+    return engine;
+}
+
+uint32_t Solver::randomInt() {
+    return rng()();
+}
+
+void Solver::seedRng(uint64_t seed, uint64_t a, uint64_t b) {
+    std::seed_seq seq{
+        uint32_t(seed), uint32_t(seed >> 32),
+        uint32_t(a), uint32_t(a >> 32),
+        uint32_t(b), uint32_t(b >> 32)
+    };
+    rng().seed(seq);
+}
+
+
+/////////////////////////////////////////
+// Edge candidates
+/////////////////////////////////////////
+
+void Solver::setEdgeNeighbourhood(size_t k, Dist radius) {
+    edge_k = k;
+    edge_radius = radius;
+}
+
+void Solver::forEachEdgeCandidate(const std::function<void(FactoryId, FactoryId)>& visit) const {
+    const std::vector<FactoryId>& ids = network.getPlaceIds();
+    const bool use_radius = !(edge_radius == Dist{0, 0});
+
+    // every pair
+    if(edge_k == 0 && !use_radius) {
+        for(size_t a = 0; a < ids.size(); a++)
+            for(size_t b = a + 1; b < ids.size(); b++)
+                visit(ids[a], ids[b]);
+        return;
+    }
+
+    // candidate pairs as positions in ids, first < second
+    std::vector<std::pair<size_t, size_t>> pairs;
+    auto addPair = [&pairs](size_t a, size_t b) {
+        if(a != b)
+            pairs.emplace_back(std::min(a, b), std::max(a, b));
+    };
+
+    if(edge_k == 0) {
+        // everything within the radius
+        std::vector<Location> locs;
+        for(FactoryId id : ids)
+            locs.push_back(network.getPlaceLoc(id));
+        SpatialIndex index(locs);
+        for(size_t a = 0; a < ids.size(); a++)
+            for(size_t b : index.withinRadius(locs[a], edge_radius))
+                if(a < b)
+                    pairs.emplace_back(a, b);
+    } else {
+        // for each resource, link suppliers with their k nearest consumers and
+        // consumers with their k nearest suppliers
+        for(Resource r = Resource(0); r != Resource::COUNT; r++) {
+            std::vector<size_t> pos[2];
+            std::vector<Location> locs[2];
+            for(size_t a = 0; a < ids.size(); a++) {
+                Quant q = network.getPlaceBaseQuants(ids[a])[r];
+                if(q != 0) {
+                    pos[q > 0].push_back(a);
+                    locs[q > 0].push_back(network.getPlaceLoc(ids[a]));
+                }
+            }
+            if(pos[0].empty() || pos[1].empty())
+                continue;
+            SpatialIndex index[2] = {SpatialIndex(locs[0]), SpatialIndex(locs[1])};
+            for(int side = 0; side < 2; side++) {
+                for(size_t i = 0; i < pos[side].size(); i++) {
+                    for(size_t j : index[!side].kNearest(locs[side][i], edge_k)) {
+                        if(use_radius && network.getPlaceDist(ids[pos[side][i]], ids[pos[!side][j]]) > edge_radius)
+                            break;
+                        addPair(pos[side][i], pos[!side][j]);
+                    }
+                }
+            }
+        }
+    }
+
+    // visit in the same order as the loop over every pair
+    std::sort(pairs.begin(), pairs.end());
+    pairs.erase(std::unique(pairs.begin(), pairs.end()), pairs.end());
+    for(const std::pair<size_t, size_t>& p : pairs)
+        visit(ids[p.first], ids[p.second]);
+}
+
+// O(R)
+bool Solver::makeFinishEdge(const Network& net, FactoryId a, FactoryId b, double dist_w, double quant_w, FinishEdge& edge) const {
+    const ResourceList& rla = net.getPlaceBaseQuants(a);
+    const ResourceList& rlb = net.getPlaceBaseQuants(b);
+    edge.rl = SparseResourceList();
+    Quant q = 0;
+    // only resources one of them supplies and the other demands
+    uint64_t a_supplies = rla.positiveMask() & rlb.negativeMask(), b_supplies = rla.negativeMask() & rlb.positiveMask();
+    for(uint64_t mask = a_supplies | b_supplies; mask; mask &= mask - 1) {
+        int r = __builtin_ctzll(mask);
+        Quant mag = std::min(abs(rla[r]), abs(rlb[r]));
+        edge.rl.set(r, ((a_supplies >> r) & 1) ? mag : -mag);
+        q += mag;
+    }
+    // if this edge is useless
+    if(q == 0)
+        return false;
+    edge.start = net.getPlaceLoc(a);
+    edge.end = net.getPlaceLoc(b);
+    // calculate prio
+    edge.prio = 0;
+    edge.prio -= dist_w*net.getPlaceDist(a, b).toDouble();
+    edge.prio += quant_w*q;
+    return true;
+}
+
+// O(E log E)
+void Solver::sortFinishEdges(std::vector<FinishEdge>& edges) {
+    // a stable sort keeps additions in order within a prio, so reverse them first
+    std::reverse(edges.begin(), edges.end());
+    std::stable_sort(edges.begin(), edges.end(), [](const FinishEdge& a, const FinishEdge& b){
+        return a.prio > b.prio;
+    });
+}
+
+// O(R)
+bool Solver::addFinishRoute(Network& nn, const FinishEdge& edge) const {
+    // find viable resources
+    //  other Routes might not allow this route to be fully executed
+    const ResourceList& start_free = nn.getPlaceUnallocated(nn.getPlaceId(edge.start)),
+                        end_free = nn.getPlaceUnallocated(nn.getPlaceId(edge.end));
+    ResourceList viable;
+    edge.rl.forEach([&](size_t r, Quant q) {
+        // find min magnitude
+        Quant mag = std::min({abs(q), abs(start_free[r]), abs(end_free[r])});
+        // update edge RL
+        viable[r] = q > 0 ? mag : -mag;
+    });
+
+    // if edge no longer viable
+    if(viable == ResourceList())
+        return false;
+
+    // find inverse of edge RL
+    ResourceList inverse = ResourceList() - viable;
+
+    bool added = nn.addRoute(edge.start, edge.end, viable, inverse);
+    assert(added);
+    return added;
+}
+
+static bool hasDeficit(const ResourceList& unallocated) {
+    return !unallocated.allPositive();
+}
+
+// O(d * f log f)
+void Solver::finishFromNearest(Network& nn) const {
+    const std::vector<FactoryId>& ids = nn.getPlaceIds();
+    FinishEdge fe;
+    for(FactoryKey key : nn.getDeficit()) {
+        FactoryId a = nn.getPlaceId(key);
+        // partners nearest first
+        std::vector<std::pair<Dist, FactoryId>> partners;
+        for(FactoryId b : ids)
+            if(b != a)
+                partners.emplace_back(nn.getPlaceDist(a, b), b);
+        std::sort(partners.begin(), partners.end());
+        for(auto p = partners.begin(); p != partners.end() && hasDeficit(nn.getPlaceUnallocated(a)); p++) {
+            if(makeFinishEdge(nn, a, p->second, 1.0, 0.0, fe))
+                addFinishRoute(nn, fe);
+        }
+    }
+}
@@ -0,0 +1,83 @@
+/*
+SolverConfig definitions
+
+Definitions for the SolverConfig struct.
+*/
+
+/////////////////
+// Includes
+/////////////////
+
+#include "../../headers/solutions/SolverConfig.h"
+#include "../../headers/solutions/solvers/GreedyEdgeList.h"
+#include "../../headers/solutions/solvers/Genetic.h"
+#include "../../headers/solutions/CanonicalExamples.h"
+#include <random>
+#include <stdexcept>
+
+/////////////////
+// Helpers
+/////////////////
+
+static const char* const ALGORITHM_NAMES[] = {"GreedyEdgeList", "Genetic"};
+static const size_t NUM_ALGORITHMS = sizeof(ALGORITHM_NAMES) / sizeof(ALGORITHM_NAMES[0]);
+
+/////////////////
+// Constructors
+/////////////////
+
+SolverConfig::SolverConfig() :
+    algorithm(GREEDY_EDGE_LIST),
+    dist_w(Solver::DEFAULT_DIST_W),
+    quant_w(Solver::DEFAULT_QUANT_W),
+    track(GreedyEdgeList::DEFAULT_TRACK),
+    num_iters(Genetic::DEFAULT_ITERS),
+    cost(ALL_COSTS),
+    constraints(),
+    threads(1),
+    seed(std::mt19937::default_seed)
+{}
+
+/////////////////
+// Functions
+/////////////////
+
+// O(f^2 * log f) for the edge list
+std::unique_ptr<Solver> SolverConfig::makeSolver(const Network& net) const
+{
+    std::unique_ptr<Solver> solver;
+    if (algorithm == GREEDY_EDGE_LIST)
+    {
+        solver.reset(new GreedyEdgeList(net, cost, constraints, dist_w, quant_w, track));
+    }
+    else if (algorithm == GENETIC)
+    {
+        solver.reset(new Genetic(net, cost, constraints, num_iters, dist_w, quant_w));
+    }
+    else
+    {
+        throw std::out_of_range("SolverConfig algorithm doesn't exist");
+    }
+    solver->setThreads(threads);
+    solver->setSeed(seed);
+    return solver;
+}
+
+const char* algorithmName(SolverConfig::Algorithm a)
+{
+    if (a < 0 || size_t(a) >= NUM_ALGORITHMS) {throw std::out_of_range("Algorithm has no name");}
+    return ALGORITHM_NAMES[a];
+}
+
+bool parseAlgorithm(std::string_view name, SolverConfig::Algorithm& a)
+{
+    for (size_t i = 0; i < NUM_ALGORITHMS; i++)
+    {
+        if (sameName(name, ALGORITHM_NAMES[i]))
+        {
+            a = SolverConfig::Algorithm(i);
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,123 @@
+/*
+ThreadPool definitions
+
+Definitions for the ThreadPool class.
+*/
+
+/////////////////
+// Includes
+/////////////////
+#include "../../headers/solutions/ThreadPool.h"
+#include <algorithm>
+
+
+/////////////////
+// Constructors
+/////////////////
+
+ThreadPool::ThreadPool(size_t num_threads) :
+    stopping_(false),
+    generation_(0),
+    active_(0),
+    body_(nullptr),
+    count_(0),
+    next_(0)
+{
+    if (num_threads == 0) {num_threads = std::max(1u, std::thread::hardware_concurrency());}
+    // the calling thread is the last worker
+    for (size_t i = 1; i < num_threads; i++)
+    {
+        workers_.emplace_back(&ThreadPool::workerLoop, this);
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    work_ready_.notify_all();
+    for (std::thread& worker : workers_)
+    {
+        worker.join();
+    }
+}
+
+/////////////////
+// Functions
+/////////////////
+
+size_t ThreadPool::size() const
+{
+    return workers_.size() + 1;
+}
+
+void ThreadPool::parallelFor(size_t count, const std::function<void(size_t)>& body)
+{
+    if (count == 0) {return;}
+    // nothing to share, skip the synchronization
+    if (workers_.empty() || count == 1)
+    {
+        for (size_t i = 0; i < count; i++) {body(i);}
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        body_ = &body;
+        count_ = count;
+        next_ = 0;
+        error_ = nullptr;
+        active_ = workers_.size();
+        generation_++;
+    }
+    work_ready_.notify_all();
+
+    runTasks();
+
+    // wait for the workers to finish their last task
+    std::unique_lock<std::mutex> lock(mutex_);
+    work_done_.wait(lock, [this]{ return active_ == 0; });
+    body_ = nullptr;
+    if (error_) {std::rethrow_exception(error_);}
+}
+
+void ThreadPool::workerLoop()
+{
+    size_t seen = 0;
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            work_ready_.wait(lock, [this, seen]{ return stopping_ || generation_ != seen; });
+            if (stopping_) {return;}
+            seen = generation_;
+        }
+
+        runTasks();
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            active_--;
+        }
+        work_done_.notify_one();
+    }
+}
+
+// claims indices until there are none left
+void ThreadPool::runTasks()
+{
+    for (size_t i = next_++; i < count_; i = next_++)
+    {
+        try
+        {
+            (*body_)(i);
+        }
+        catch (...)
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!error_) {error_ = std::current_exception();}
+        }
+    }
+}
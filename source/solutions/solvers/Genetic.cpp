@@ -10,6 +10,7 @@ Definitions for the BruteForce class.
 // Includes
 /////////////////
 #include "../../../headers/solutions/solvers/Genetic.h"
+#include "../../../headers/solutions/ThreadPool.h"
 #include <list>
 #include <assert.h>
 #include <algorithm>
@@ -18,77 +19,52 @@ Definitions for the BruteForce class.
 #include <functional>
 #include <numeric>
 
+/////////////////
+// Helpers
+/////////////////
+
+// 0 to n-1 shuffled with g, in memory from mem
+// shuffles the same way as the getRandom...Ordering functions
+template <typename T>
+static std::pmr::vector<T> shuffledIndices(size_t n, std::mt19937& g, std::pmr::memory_resource* mem) {
+    std::pmr::vector<T> inds(n, mem);
+    for(size_t i = 0; i < inds.size(); i++)
+        inds[i] = i;
+    std::shuffle(inds.begin(), inds.end(), g);
+    return inds;
+}
+
 /////////////////
 // Functions
 /////////////////
 // constructor
-Genetic::Genetic(const Network& net, const CostFunct cos, const Constraints constr, size_t iters) 
+Genetic::Genetic(const Network& net, const CostFunct cos, const Constraints constr, size_t iters, double d_w, double q_w) 
     : Solver(net, cos, constr), num_iters(iters){
     // generate list used for finishing
-    generateEdgeList();
+    generateEdgeList(d_w, q_w);
     //if(!constraints(network))
     //    network = finishNetwork(network);
 }
 
-void Genetic::addEdge(FinishEdge fe) {
-    auto comp = [](const FinishEdge& a, const FinishEdge& b){ 
-        return a.prio > b.prio; 
-    };
-    auto it = std::lower_bound(edge_list.begin(), edge_list.end(), fe, comp);
-    edge_list.insert(it, fe);
-}
-
 void Genetic::generateEdgeList(double DIST_W, double QUANT_W) {
-    ResourceList rla, rlb, rl_shared;
-
-    // for every pair of factories
-    // auto = std::map<FactoryKey, Factory, LocationCompare>::const_iterator
-    for (auto it_a = network.factCBegin(); it_a != network.factCEnd(); it_a++) {
-        rla = it_a->second.getBaseQuants();
-        // nothing to be done for a Junction
-        if(rla == ResourceList())
-            continue;
-        
-        // auto = std::map<FactoryKey, Factory, LocationCompare>::const_iterator
-        for (auto it_b = std::next(it_a); it_b != network.factCEnd(); it_b++) {
-            rlb = it_b->second.getBaseQuants();
-            // if Factories could fulfill each other's demands
-            // add edge [useful RLs, Dist]
-            rl_shared = ResourceList();
-            Quant q = 0;
-            for(Resource r = Resource(0); r != Resource::COUNT; r++) {
-                if(signof(rla[r]) != signof(rlb[r]) && signof(rla[r]) != ZERO_S && signof(rlb[r]) != ZERO_S) {
-                    Quant mag = std::min(abs(rla[r]), abs(rlb[r]));
-                    if(signof(rla[r]) == POS_S)
-                        rl_shared[r] = mag;
-                    else
-                        rl_shared[r] = -mag;
-                    q += mag;
-                }
-            }
-            // if this edge is useful
-            if(q != 0) {
-                // calculate prio
-                double prio = 0;
-                prio -= DIST_W*dist(it_a->second.getLoc(), it_b->second.getLoc()).toDouble();
-                prio += QUANT_W*q;
-                // add edge
-                addEdge((FinishEdge){
-                    it_a->first, 
-                    it_b->first, 
-                    rl_shared,
-                    prio
-                });
-            }
-        }
-    }
+    edge_list.clear();
+    FinishEdge fe;
+    // for every pair of factories that may trade
+    forEachEdgeCandidate([&](FactoryId a, FactoryId b) {
+        // if Factories could fulfill each other's demands
+        // add edge [useful RLs, Dist]
+        if(makeFinishEdge(network, a, b, DIST_W, QUANT_W, fe))
+            edge_list.push_back(fe);
+    });
+    // sort once, rather than inserting each edge in order
+    sortFinishEdges(edge_list);
 }
 
 std::vector<size_t> Genetic::getRandomEdgeOrdering() const {
     std::vector<size_t> inds(edge_list.size());
     for(size_t i = 0; i < inds.size(); i++)
         inds[i] = i;
-    std::random_shuffle(inds.begin(), inds.end());
+    std::shuffle(inds.begin(), inds.end(), rng());
     return inds;
 }
 
@@ -96,19 +72,35 @@ std::vector<RouteKey> Genetic::getRandomRouteOrdering(const Network& net) const
     std::vector<RouteKey> inds(net.getNumRoutes());
     for(size_t i = 0; i < inds.size(); i++)
         inds[i] = i;
-    std::random_shuffle(inds.begin(), inds.end());
+    std::shuffle(inds.begin(), inds.end(), rng());
     return inds;
 }
 
 const size_t POP_SIZE = 100;
+// Each generation convolves disjoint groups of parents into children. Children
+// are built on the thread pool from a snapshot of the population, each with its
+// own random stream seeded from (seed, generation, child), then merged into the
+// population in child order. So a given seed always gives the same result,
+// however many threads are used.
+// Each child's scratch containers come from its own arena, which is reset
+// every generation.
 Network Genetic::solve() {
+    ThreadPool pool(num_threads);
+    memory_stats = MemoryStats();
+    // drives the choices made between generations, only used on this thread
+    std::seed_seq gen_seq{uint32_t(seed), uint32_t(seed >> 32)};
+    std::mt19937 gen_rng(gen_seq);
+
     // start with naively finished network
     std::vector<Network> best_solutions(POP_SIZE);
     std::vector<Cost> best_costs(POP_SIZE);
-    for(size_t i = 0; i < POP_SIZE; i++) {
+    resetArenas(POP_SIZE);
+    pool.parallelFor(POP_SIZE, [&](size_t i){
+        seedRng(seed, 0, i);
+        ScratchScope scope(arenas[i].get());
         best_solutions[i] = randomlyFinishNetwork(network); //randomStartingCondition(network);
         best_costs[i] = cost(best_solutions[i]);
-    }
+    });
     // sort solutions by costs
     std::vector<size_t> sort_inds(POP_SIZE);
     for(size_t i = 0; i < POP_SIZE; i++)
@@ -116,16 +108,17 @@ Network Genetic::solve() {
     // sort indices
     std::sort(
         sort_inds.begin(), sort_inds.end(),
-        [best_costs](const size_t& lhs, const size_t& rhs){ 
+        [&best_costs](const size_t& lhs, const size_t& rhs){ 
             return best_costs[lhs] < best_costs[rhs];
         }
     );
     // make temps
-    std::vector<Network> temp_bs(best_solutions);
+    std::vector<Network> temp_bs(std::move(best_solutions));
     std::vector<Cost> temp_cs(best_costs);
+    best_solutions.resize(POP_SIZE);
     // assign from temps
     for(size_t i = 0; i < POP_SIZE; i++) {
-        best_solutions[i] = temp_bs[sort_inds[i]];
+        best_solutions[i] = std::move(temp_bs[sort_inds[i]]);
         best_costs[i] = temp_cs[sort_inds[i]];
     }
 
@@ -138,21 +131,35 @@ Network Genetic::solve() {
         std::array<size_t, POP_SIZE> sol_inds;
         for(size_t i = 0; i < POP_SIZE; i++)
             sol_inds[i] = i;
-        std::random_shuffle(sol_inds.begin(), sol_inds.end());
+        std::shuffle(sol_inds.begin(), sol_inds.end(), gen_rng);
 
+        // split shuffled solutions into parent groups
+        //  children only see this generation's parents, copies share their data
+        std::vector<std::vector<Network>> parents;
         for(size_t sol_ind_i = 0; sol_ind_i < POP_SIZE; ) {
             // pick random count
-            size_t count = std::min(size_t(rand() % 4 + 2), POP_SIZE - sol_ind_i);
+            size_t count = std::min(size_t(gen_rng() % 4 + 2), POP_SIZE - sol_ind_i);
             // make parent's vector
-            std::vector<Network> parents(count);
+            parents.emplace_back(count);
             for(size_t c = 0; c < count; c++)
-                parents[c] = best_solutions[sol_inds[sol_ind_i+c]];
+                parents.back()[c] = best_solutions[sol_inds[sol_ind_i+c]];
             sol_ind_i += count;
-            // convolve and mutate
-            Network mutated(convolveNetworks(parents));
+        }
 
-            // track best solution
-            Cost new_cost = cost(mutated);
+        // convolve and mutate
+        std::vector<Network> children(parents.size());
+        std::vector<Cost> child_costs(parents.size());
+        resetArenas(parents.size());
+        pool.parallelFor(parents.size(), [&](size_t c){
+            seedRng(seed, iter + 1, c);
+            ScratchScope scope(arenas[c].get());
+            children[c] = convolveNetworks(parents[c]);
+            child_costs[c] = cost(children[c]);
+        });
+
+        // merge children in order
+        for(size_t c = 0; c < children.size(); c++) {
+            Cost new_cost = child_costs[c];
             // check if new best
             if(new_cost < worst_best_cost) {
                 // find insertion point
@@ -160,18 +167,18 @@ Network Genetic::solve() {
                     best_costs.begin(), 
                     std::lower_bound(best_costs.begin(), best_costs.end(), new_cost)
                 );
-                // shift
-                for(size_t move_i = POP_SIZE - 1; move_i > ins; move_i--) {
-                    best_solutions[move_i] = best_solutions[move_i-1];
-                    best_costs[move_i] = best_costs[move_i-1];
-                }
+                // shift, moving so shared network data isn't copied
+                std::move_backward(best_solutions.begin() + ins, best_solutions.end() - 1, best_solutions.end());
+                std::move_backward(best_costs.begin() + ins, best_costs.end() - 1, best_costs.end());
                 // insert
-                best_solutions[ins] = mutated;
+                best_solutions[ins] = std::move(children[c]);
                 best_costs[ins] = new_cost;
                 worst_best_cost = best_costs.back();
             }
         }
     }
+    // count the last generation
+    resetArenas(0);
     
     return best_solutions[0];
 }
@@ -186,37 +193,17 @@ Network Genetic::finishNetwork(const Network& net) const {
     Network nn(net);
     
     // while not fulfilling constraints yet
+    // the question constraints can't change by adding routes,
+    // so only the answer constraints need rechecking
     // go over edges in order of priority
     //  auto = std::vector<FinishEdge>::iterator
-    for(auto it = edge_list.begin(); !constraints(nn); it++) {
-        // assert we have edges left
-        assert(it != edge_list.end());
-
-        // find viable resources
-        //  other Routes might not allow this route to be fully executed
-        ResourceList start_free = nn.getPlace(it->start).getUnallocated(),
-                     end_free = nn.getPlace(it->end).getUnallocated(),
-                     viable;
-        Quant mag;
-        for(Resource r = Resource(0); r != Resource::COUNT; r++) {
-            // find min magnitude
-            mag = std::min({abs(it->rl[r]), abs(start_free[r]), abs(end_free[r])});
-            // update edge RL
-            if(signof(it->rl[r]) == POS_S)
-                viable[r] = mag;
-            else
-                viable[r] = -mag;
-        }
-        
-        // if edge still viable
-        if(!(viable == ResourceList())) {
-            // find inverse of edge RL
-            ResourceList inverse;
-            for(Resource r = Resource(0); r != Resource::COUNT; r++)
-                inverse[r] = -viable[r];
-            
-            assert(nn.addRoute(it->start, it->end, viable, inverse));
+    for(auto it = edge_list.begin(); !constraints.quickCheck(nn); it++) {
+        // an edge list built with a neighbourhood may run out
+        if(it == edge_list.end()) {
+            finishFromNearest(nn);
+            break;
         }
+        addFinishRoute(nn, *it);
     }
 
     // once constraints satisfied, return network
@@ -233,42 +220,20 @@ Network Genetic::randomlyFinishNetwork(const Network& net) const {
     Network nn(net);
     
     // generate random order of edges
-    std::vector<size_t> inds = getRandomEdgeOrdering();
+    std::pmr::vector<size_t> inds = shuffledIndices<size_t>(edge_list.size(), rng(), scratch());
 
     // while not fulfilling constraints yet
+    // the question constraints can't change by adding routes,
+    // so only the answer constraints need rechecking
     // go over edges in random order
     //  auto = std::vector<size_t>::iterator
-    for(auto it = inds.begin(); !constraints(nn); it++) {
-        // assert we have edges left
-        assert(it != inds.end());
-
-        // find viable resources
-        //  other Routes might not allow this route to be fully executed
-        ResourceList start_free = nn.getPlace(edge_list[*it].start).getUnallocated(),
-                     end_free = nn.getPlace(edge_list[*it].end).getUnallocated(),
-                     viable;
-        Quant mag;
-        for(Resource r = Resource(0); r != Resource::COUNT; r++) {
-            // find min magnitude
-            mag = std::min({abs(edge_list[*it].rl[r]), abs(start_free[r]), abs(end_free[r])});
-            // update edge RL
-            if(signof(edge_list[*it].rl[r]) == POS_S)
-                viable[r] = mag;
-            else
-                viable[r] = -mag;
-        }
-        
-        // if edge still viable
-        if(!(viable == ResourceList())) {
-            // find inverse of edge RL
-            ResourceList inverse;
-            for(Resource r = Resource(0); r != Resource::COUNT; r++)
-                inverse[r] = -viable[r];
-            
-
-            // add route
-            assert(nn.addRoute(edge_list[*it].start, edge_list[*it].end, viable, inverse));
+    for(auto it = inds.begin(); !constraints.quickCheck(nn); it++) {
+        // an edge list built with a neighbourhood may run out
+        if(it == inds.end()) {
+            finishFromNearest(nn);
+            break;
         }
+        addFinishRoute(nn, edge_list[*it]);
     }
 
     // once constraints satisfied, return network
@@ -293,7 +258,7 @@ Network Genetic::mutateNetwork(const Network& net) const {
 
     // randomly select mutation
     size_t total_w = std::accumulate(MUTATION_W.begin(), MUTATION_W.end(), 0);
-    size_t w = rand() % total_w;
+    size_t w = randomInt() % total_w;
     size_t m = 0;
     while(w >= MUTATION_W[m]) {
         w -= MUTATION_W[m];
@@ -303,11 +268,11 @@ Network Genetic::mutateNetwork(const Network& net) const {
     {
     // reverse
     case 0:
-        nn = reverseRoute(nn, rand() % nn.getNumRoutes());
+        nn = reverseRoute(nn, randomInt() % nn.getNumRoutes());
         break;
     // rotate
     case 1:
-        nn = rotateRoute(nn, rand() % nn.getNumRoutes());
+        nn = rotateRoute(nn, randomInt() % nn.getNumRoutes());
         break;
     // randomlySplice
     case 2:
@@ -319,7 +284,7 @@ Network Genetic::mutateNetwork(const Network& net) const {
         break;
     // polish
     case 4:
-        nn = dropRoute(nn, rand() % nn.getNumRoutes());
+        nn = dropRoute(nn, randomInt() % nn.getNumRoutes());
         break;
     }
     
@@ -435,17 +400,19 @@ Network Genetic::randomlySpliceRoute(const Network& net) const {
     Network nn(net);
     // perform mutations
     FactoryKey link(0, 0);
-    std::vector<RouteKey>::iterator r1, r2;
+    std::pmr::vector<RouteKey>::iterator r1, r2;
     bool splice_chosen = false;
 
     // traverse pairs of routes in random order
-    std::vector<RouteKey> inds = getRandomRouteOrdering(nn);
+    std::pmr::vector<RouteKey> inds = shuffledIndices<RouteKey>(nn.getNumRoutes(), rng(), scratch());
     for(r1 = inds.begin(); !splice_chosen && r1 != (--inds.end()); r1++) {
         for(r2 = r1+1; !splice_chosen && r2 != inds.end(); r2++) {
             // find shared facts 
-            std::vector<FactoryKey> st1 = nn.getRouteStops(*r1), st2 = nn.getRouteStops(*r2);
-            std::random_shuffle(st1.begin(), st1.end());
-            std::random_shuffle(st2.begin(), st2.end());
+            const Route &route1 = nn.getRoute(*r1), &route2 = nn.getRoute(*r2);
+            std::pmr::vector<FactoryKey> st1(route1.stopKeys(), route1.stopKeys() + route1.size(), scratch()),
+                                         st2(route2.stopKeys(), route2.stopKeys() + route2.size(), scratch());
+            std::shuffle(st1.begin(), st1.end(), rng());
+            std::shuffle(st2.begin(), st2.end(), rng());
             // traverse pairs of facts in random order
             for(auto fk = st1.begin(); !splice_chosen && fk != st1.end(); fk++) {
                 for(auto fk2 = st2.begin(); !splice_chosen && fk2 != st2.end(); fk2++) {
@@ -474,7 +441,7 @@ Network Genetic::multiSplice(const Network& net, const size_t P) const {
     Network nn(net);
     // randomly join (check that join is still performed)
     size_t routeCount = nn.getNumRoutes();
-    while(routeCount == nn.getNumRoutes() && (rand() % routeCount >= P)) {
+    while(routeCount == nn.getNumRoutes() && (randomInt() % routeCount >= P)) {
         nn = randomlySpliceRoute(nn);
         routeCount--;
     }
@@ -503,14 +470,14 @@ Network Genetic::convolveNetworks(std::vector<Network> nets) const {
         // while we sill have parents
         while(nets.size()) {
             // randomly pick net
-            size_t i = rand() % nets.size();
+            size_t i = randomInt() % nets.size();
             // check that net has routes
             if(nets[i].getNumRoutes() == 0) {
                 nets.erase(nets.begin()+1);
                 continue;
             }
             // randomly pick route
-            size_t j = rand() % nets[i].getNumRoutes();
+            size_t j = randomInt() % nets[i].getNumRoutes();
             // try to add Route
             nn.addRoute(nets[i].getRoute(j));
             // erase Route from parent
@@ -548,13 +515,11 @@ Network Genetic::fullyPolish(const Network& net, const size_t TRACK) const {
                     best_costs.begin(), 
                     std::lower_bound(best_costs.begin(), best_costs.end(), new_cost)
                 );
-                // shift
-                for(size_t move_i = TRACK - 1; move_i > ins; move_i--) {
-                    best_solutions[move_i] = best_solutions[move_i-1];
-                    best_costs[move_i] = best_costs[move_i-1];
-                }
+                // shift, moving so shared network data isn't copied
+                std::move_backward(best_solutions.begin() + ins, best_solutions.end() - 1, best_solutions.end());
+                std::move_backward(best_costs.begin() + ins, best_costs.end() - 1, best_costs.end());
                 // insert
-                best_solutions[ins] = mutated;
+                best_solutions[ins] = std::move(mutated);
                 best_costs[ins] = new_cost;
                 worst_best_cost = best_costs.back();
             }
@@ -10,6 +10,7 @@ Definitions for the GreedyEdgeList solver class.
 // Includes
 /////////////////
 #include "../../../headers/solutions/solvers/GreedyEdgeList.h"
+#include "../../../headers/solutions/ThreadPool.h"
 #include <algorithm>
 #include <assert.h>
 
@@ -17,6 +18,13 @@ Definitions for the GreedyEdgeList solver class.
 // Functions
 /////////////////
 
+GreedyEdgeList::PolishSolution::PolishSolution(std::pmr::memory_resource* mem)
+    : cost(0), shared_facts(mem), shared2net(mem), net2shared(mem) {}
+
+GreedyEdgeList::PolishSolution::PolishSolution(const PolishSolution& other, std::pmr::memory_resource* mem)
+    : net(other.net), cost(other.cost), cost_cache(other.cost_cache),
+      shared_facts(other.shared_facts, mem), shared2net(other.shared2net, mem), net2shared(other.net2shared, mem) {}
+
 GreedyEdgeList::GreedyEdgeList(const Network& net, const CostFunct cos, const Constraints constr, double d_w, double q_w, size_t track) 
     : Solver(net, cos, constr), DIST_W(d_w), QUANT_W(q_w), TRACK(track) {
     // generate list used for finishing
@@ -26,66 +34,21 @@ GreedyEdgeList::GreedyEdgeList(const Network& net, const CostFunct cos, const Co
         fact_list.push_back(it->first);
 }
 
-// O(log f)
-//    O(log [edges])
-//    [edges] is f^2 complexity
-//    O(log f^2) -> O (log f)
-void GreedyEdgeList::addEdge(FinishEdge fe) {
-    auto comp = [](const FinishEdge& a, const FinishEdge& b){ 
-        return a.prio > b.prio; 
-    };
-    // sort container, so this is log n
-    auto it = std::lower_bound(edge_list.begin(), edge_list.end(), fe, comp);
-    edge_list.insert(it, fe);
-}
-
 // O(f^2 * log f)
 //   f^2 pairs to compare
-//   log f to insert edge to sorted list
+//   log f per edge to sort the list once at the end
 void GreedyEdgeList::generateEdgeList() {
-    ResourceList rla, rlb, rl_shared;
-
-    // for every pair of factories
-    // auto = std::map<FactoryKey, Factory, LocationCompare>::const_iterator
-    for (auto it_a = network.factCBegin(); it_a != network.factCEnd(); it_a++) {
-        rla = it_a->second.getBaseQuants();
-        // nothing to be done for a Junction
-        if(rla == ResourceList())
-            continue;
-        
-        // auto = std::map<FactoryKey, Factory, LocationCompare>::const_iterator
-        for (auto it_b = std::next(it_a); it_b != network.factCEnd(); it_b++) {
-            rlb = it_b->second.getBaseQuants();
-            // if Factories could fulfill each other's demands
-            // add edge [useful RLs, Dist]
-            rl_shared = ResourceList();
-            Quant q = 0;
-            for(Resource r = Resource(0); r != Resource::COUNT; r++) {
-                if(signof(rla[r]) != signof(rlb[r]) && signof(rla[r]) != ZERO_S && signof(rlb[r]) != ZERO_S) {
-                    Quant mag = std::min(abs(rla[r]), abs(rlb[r]));
-                    if(signof(rla[r]) == POS_S)
-                        rl_shared[r] = mag;
-                    else
-                        rl_shared[r] = -mag;
-                    q += mag;
-                }
-            }
-            // if this edge is useful
-            if(q != 0) {
-                // calculate prio
-                double prio = 0;
-                prio -= DIST_W*dist(it_a->second.getLoc(), it_b->second.getLoc()).toDouble();
-                prio += QUANT_W*q;
-                // add edge
-                addEdge((FinishEdge){
-                    it_a->first, 
-                    it_b->first, 
-                    rl_shared,
-                    prio
-                });
-            }
-        }
-    }
+    edge_list.clear();
+    FinishEdge fe;
+    // for every pair of factories that may trade
+    forEachEdgeCandidate([&](FactoryId a, FactoryId b) {
+        // if Factories could fulfill each other's demands
+        // add edge [useful RLs, Dist]
+        if(makeFinishEdge(network, a, b, DIST_W, QUANT_W, fe))
+            edge_list.push_back(fe);
+    });
+    // sort once, rather than inserting each edge in order
+    sortFinishEdges(edge_list);
 }
 
 // O(r)
@@ -93,14 +56,14 @@ std::vector<RouteKey> GreedyEdgeList::getRandomRouteOrdering(const Network& net)
     std::vector<RouteKey> inds(net.getNumRoutes());
     for(size_t i = 0; i < inds.size(); i++)
         inds[i] = i;
-    std::random_shuffle(inds.begin(), inds.end());
+    std::shuffle(inds.begin(), inds.end(), rng());
     return inds;
 }
 
 // O(f)
 std::vector<FactoryKey> GreedyEdgeList::getRandomFactoryOrdering() const {
     std::vector<FactoryKey>fs(fact_list.begin(), fact_list.end());
-    std::random_shuffle(fs.begin(), fs.end());
+    std::shuffle(fs.begin(), fs.end(), rng());
     return fs;
 }
 
@@ -113,6 +76,7 @@ const PairList<Network, Cost>& GreedyEdgeList::getHistory() const {
 // O(T * r^4 * f_r^2) ~ O(T * r^2 * f^2)
 //   T := TRACK
 Network GreedyEdgeList::solve() {
+    memory_stats = MemoryStats();
     return fullyPolish(finishNetwork(network));
 }
 
@@ -128,37 +92,17 @@ Network GreedyEdgeList::finishNetwork(const Network& net) const {
     Network nn(net);
     
     // while not fulfilling constraints yet
+    // the question constraints can't change by adding routes,
+    // so only the answer constraints need rechecking
     // go over edges in order of priority
     //  auto = std::vector<FinishEdge>::iterator
-    for(auto it = edge_list.begin(); !constraints(nn); it++) {
-        // assert we have edges left
-        assert(it != edge_list.end());
-
-        // find viable resources
-        //  other Routes might not allow this route to be fully executed
-        ResourceList start_free = nn.getPlace(it->start).getUnallocated(),
-                     end_free = nn.getPlace(it->end).getUnallocated(),
-                     viable;
-        Quant mag;
-        for(Resource r = Resource(0); r != Resource::COUNT; r++) {
-            // find min magnitude
-            mag = std::min({abs(it->rl[r]), abs(start_free[r]), abs(end_free[r])});
-            // update edge RL
-            if(signof(it->rl[r]) == POS_S)
-                viable[r] = mag;
-            else
-                viable[r] = -mag;
-        }
-        
-        // if edge still viable
-        if(!(viable == ResourceList())) {
-            // find inverse of edge RL
-            ResourceList inverse;
-            for(Resource r = Resource(0); r != Resource::COUNT; r++)
-                inverse[r] = -viable[r];
-            
-            assert(nn.addRoute(it->start, it->end, viable, inverse));
+    for(auto it = edge_list.begin(); !constraints.quickCheck(nn); it++) {
+        // an edge list built with a neighbourhood may run out
+        if(it == edge_list.end()) {
+            finishFromNearest(nn);
+            break;
         }
+        addFinishRoute(nn, *it);
     }
 
     // once constraints satisfied, return network
@@ -271,6 +215,12 @@ void GreedyEdgeList::spliceRoutes(PolishSolution& sltn, RouteKey r1, RouteKey r2
         }
     }
 
+    // re-score only the two routes touched by the splice
+    NetworkEdit edit;
+    edit.replaced.emplace_back(r1, sltn.net.getRoute(r1));
+    edit.erased.push_back(r2);
+    sltn.cost = cost.apply(sltn.cost_cache, edit);
+
     // update RouteKeyTrans
     // update shared2net
     sltn.shared2net[sltn.net2shared[r2]] = -1;
@@ -288,14 +238,16 @@ void GreedyEdgeList::randomlySpliceRoute(PolishSolution& sltn) const {
     bool splice_chosen = false;
 
     // traverse pairs of routes in random order
-    std::vector<FactoryKey> f_ord = getRandomFactoryOrdering();
-    std::vector<RouteKey> rk_temp;
+    //   shuffled like getRandomFactoryOrdering
+    std::pmr::vector<FactoryKey> f_ord(fact_list.begin(), fact_list.end(), scratch());
+    std::shuffle(f_ord.begin(), f_ord.end(), rng());
+    std::pmr::vector<RouteKey> rk_temp(scratch());
     for(FactoryKey fk : f_ord) {
         auto search_it = sltn.shared_facts.find(fk);
         if(search_it != sltn.shared_facts.end() && search_it->second.size() >= 2) {
             link = fk;
-            rk_temp = std::vector<RouteKey>(search_it->second.begin(), search_it->second.end());
-            std::random_shuffle(rk_temp.begin(), rk_temp.end());
+            rk_temp.assign(search_it->second.begin(), search_it->second.end());
+            std::shuffle(rk_temp.begin(), rk_temp.end(), rng());
             r1 = sltn.shared2net[rk_temp.front()];
             r2 = sltn.shared2net[*(++(rk_temp.begin()))];
             splice_chosen = true;
@@ -317,7 +269,7 @@ void GreedyEdgeList::randomlySpliceRoute(PolishSolution& sltn) const {
 //     (R+1)*(P/P+1)
 //    equation adapted from: https://math.stackexchange.com/a/75970
 GreedyEdgeList::PolishSolution GreedyEdgeList::multiSplice(const PolishSolution& sltn, size_t P) const {
-    PolishSolution n_sltn(sltn);
+    PolishSolution n_sltn(sltn, scratch());
     // randomly join (check that join is still performed)
     size_t routeCount = n_sltn.net.getNumRoutes();
     // don't use P that's too big compared to Route size
@@ -326,8 +278,8 @@ GreedyEdgeList::PolishSolution GreedyEdgeList::multiSplice(const PolishSolution&
     do {
         randomlySpliceRoute(n_sltn);
         routeCount--;
-    } while(routeCount == n_sltn.net.getNumRoutes() && (rand() % routeCount >= P));
-    n_sltn.cost = cost(n_sltn.net);
+    } while(routeCount == n_sltn.net.getNumRoutes() && (randomInt() % routeCount >= P));
+    // cost is kept up to date by each splice
     return n_sltn;
 }
 
@@ -336,9 +288,19 @@ GreedyEdgeList::PolishSolution GreedyEdgeList::multiSplice(const PolishSolution&
 //    iterations on order of r
 //    call multisplice on order of iters*track
 //    multisplice on order of O(r * (f + r + r_f))
+// Tracks are spliced concurrently on a thread pool, each from the solutions
+// at the start of the iteration and with its own random stream seeded from
+// (seed, iter, track). Insertions are then applied in track order, so a given
+// seed gives the same result however many threads are used.
+// A track's mutation lives in that track's arena until the iteration ends,
+// the ones good enough to keep are copied out into kept memory.
 Network GreedyEdgeList::fullyPolish(const Network& net) {
+    ThreadPool pool(num_threads);
+    CountingResource kept(memory_upstream);
+
     // generate intial shared list
-    PolishSolution::SharedList base_shared;
+    PolishSolution start(&kept);
+    PolishSolution::SharedList& base_shared = start.shared_facts;
     RouteKey rki = 0;
     for(auto r_it = net.routeCBegin(); r_it != net.routeCEnd(); r_it++) {
         for(auto f_it = r_it->cbegin(); f_it != r_it->cend(); f_it++) {
@@ -356,7 +318,7 @@ Network GreedyEdgeList::fullyPolish(const Network& net) {
                     search_it, 
                     std::make_pair(
                         f_it->first, 
-                        (std::list<RouteKey>){rki}
+                        std::pmr::list<RouteKey>{rki}
                     )
                 );
             }
@@ -364,25 +326,41 @@ Network GreedyEdgeList::fullyPolish(const Network& net) {
         rki++;
     }
     // create inital translator
-    PolishSolution::RouteKeyTrans base_trans(net.getNumRoutes());
+    PolishSolution::RouteKeyTrans& base_trans = start.shared2net;
+    base_trans.resize(net.getNumRoutes());
     for(size_t i = 0; i < base_trans.size(); i++)
         base_trans[i] = i;
+    start.net2shared = base_trans;
     // start with naively finished network
-    std::vector<PolishSolution> best_solutions(TRACK, (PolishSolution){
-        net, 
-        cost(net), 
-        base_shared, 
-        base_trans, 
-        base_trans
-    });
+    start.net = net;
+    start.cost = cost(net);
+    start.cost_cache = cost.buildCache(net);
+    std::vector<PolishSolution> best_solutions;
+    best_solutions.reserve(TRACK);
+    for(size_t i = 0; i < TRACK; i++)
+        best_solutions.emplace_back(start, &kept);
     Cost worst_best_cost = best_solutions.back().cost;
 
     size_t ITERS = net.getNumRoutes();
     // for # iters
     for(size_t iter = 0; iter < ITERS; iter++) {
+        // splice (multiple times)
+        //  tracks only read best_solutions, which isn't changed until they are all done
+        //  nothing from the last iteration is left in the arenas
+        resetArenas(TRACK);
+        std::vector<PolishSolution> mutations;
+        mutations.reserve(TRACK);
+        for(size_t i = 0; i < TRACK; i++)
+            mutations.emplace_back(arenas[i].get());
+        pool.parallelFor(TRACK, [&](size_t i){
+            seedRng(seed, iter, i);
+            ScratchScope scope(arenas[i].get());
+            mutations[i] = multiSplice(best_solutions[i], 4);
+        });
+
+        // insert in track order
         for(size_t i = 0; i < TRACK; i++) {
-            // splice (multiple times)
-            PolishSolution mutated(multiSplice(best_solutions[i], 4));
+            PolishSolution& mutated = mutations[i];
 
             // check if new best
             if(mutated.cost < worst_best_cost) {
@@ -398,12 +376,10 @@ Network GreedyEdgeList::fullyPolish(const Network& net) {
                         }
                     )
                 );
-                // shift
-                for(size_t move_i = TRACK - 1; move_i > ins; move_i--) {
-                    best_solutions[move_i] = best_solutions[move_i-1];
-                }
+                // shift, moving so solutions and their cost caches aren't copied
+                std::move_backward(best_solutions.begin() + ins, best_solutions.end() - 1, best_solutions.end());
                 // insert
-                best_solutions[ins] = mutated;
+                best_solutions[ins] = std::move(mutated);
                 worst_best_cost = best_solutions.back().cost;
             }
         }
@@ -411,6 +387,9 @@ Network GreedyEdgeList::fullyPolish(const Network& net) {
         ITERS = std::min(ITERS, best_solutions[0].net.getNumRoutes()+2);
         history.emplace_back(best_solutions[0].net, best_solutions[0].cost);
     }
+    // count the last iteration and the kept solutions
+    resetArenas(0);
+    memory_stats += kept.takeStats();
     
     return best_solutions[0].net;
 }
\ No newline at end of file
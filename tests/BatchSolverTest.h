@@ -0,0 +1,97 @@
+/*
+BatchSolver unit test
+
+This file tests solving many networks at once with the BatchSolver,
+defined in BatchSolver.h
+*/
+
+/////////////////
+// Includes
+/////////////////
+
+#include <gtest/gtest.h>
+#include "../headers/solutions/BatchSolver.h"
+#include "../headers/solutions/CanonicalExamples.h"
+#include <atomic>
+#include <stdexcept>
+
+/////////////////
+// tests
+/////////////////
+
+namespace BatchSolverTest {
+    // every job is reported once, and solves the same as on its own
+    TEST(BatchSolverTest, MatchesSolver) {
+        SolverConfig config;
+        std::vector<Network> nets;
+        for (int seed = 0; seed < 6; seed++) {nets.push_back(randomNetwork(seed, 15, 100));}
+
+        BatchSolver batch(config, 3);
+        for (size_t i = 0; i < nets.size(); i++) {batch.add("random " + std::to_string(i), nets[i]);}
+        EXPECT_EQ(batch.size(), nets.size());
+
+        std::vector<int> seen(nets.size(), 0);
+        long long cpu_us = 0;
+        BatchStats stats = batch.run([&](const BatchResult& result) {
+            ASSERT_LT(result.index, nets.size());
+            seen[result.index]++;
+            EXPECT_EQ(result.name, "random " + std::to_string(result.index));
+            EXPECT_TRUE(result.error.empty());
+            EXPECT_TRUE(result.valid);
+            EXPECT_EQ(result.cost, config.cost(config.makeSolver(nets[result.index])->solve()));
+            EXPECT_EQ(result.cost, config.cost(result.solution));
+            EXPECT_GE(result.solve_cpu_us, 0);
+            cpu_us += result.solve_cpu_us;
+        });
+        EXPECT_EQ(seen, std::vector<int>(nets.size(), 1));
+        EXPECT_EQ(stats.solved, nets.size());
+        EXPECT_EQ(stats.failed, 0);
+        EXPECT_GT(stats.networksPerSecond(), 0.0);
+        EXPECT_EQ(stats.solve_cpu_us, cpu_us);
+        EXPECT_GT(stats.solve_cpu_us, 0);
+        EXPECT_DOUBLE_EQ(stats.cpuMicrosPerNetwork(), double(cpu_us) / nets.size());
+        EXPECT_GT(stats.memory.allocations, 0);
+        // the jobs are gone once run
+        EXPECT_EQ(batch.size(), 0);
+    }
+
+    // a failing job doesn't stop the others
+    TEST(BatchSolverTest, Errors) {
+        BatchSolver batch(SolverConfig(), 2);
+        batch.add("good", CANON_DUAL_SERVE);
+        batch.add("bad", []() -> Network { throw std::runtime_error("no such outpost"); });
+        batch.add("also good", CANON_DUAL_SERVE);
+
+        std::vector<std::string> errors(3);
+        BatchStats stats = batch.run([&](const BatchResult& result) { errors[result.index] = result.error; });
+        EXPECT_EQ(errors, std::vector<std::string>({"", "no such outpost", ""}));
+        EXPECT_EQ(stats.solved, 2);
+        EXPECT_EQ(stats.failed, 1);
+    }
+
+    // loaders run on the workers, and only once
+    TEST(BatchSolverTest, Loaders) {
+        std::atomic<int> calls(0);
+        BatchSolver batch(SolverConfig(), 0);
+        for (int i = 0; i < 8; i++)
+        {
+            batch.add(std::to_string(i), [&calls]() { calls++; return CANON_DUAL_SERVE; });
+        }
+        EXPECT_EQ(calls, 0);
+        size_t results = 0;
+        batch.run([&](const BatchResult&) { results++; });
+        EXPECT_EQ(calls, 8);
+        EXPECT_EQ(results, 8);
+    }
+
+    TEST(BatchSolverTest, HandlerThrows) {
+        BatchSolver batch(SolverConfig(), 1);
+        for (int i = 0; i < 4; i++) {batch.add(std::to_string(i), CANON_DUAL_SERVE);}
+        size_t results = 0;
+        EXPECT_THROW(batch.run([&](const BatchResult&) {
+            results++;
+            throw std::runtime_error("disk full");
+        }), std::runtime_error);
+        EXPECT_EQ(results, 1);
+    }
+}
@@ -51,7 +51,7 @@ namespace ConstraintsTest {
             // add extra
             net.addFactory(Factory(13, 12, ResourceList({
                 {Resource::Copper, 1}, 
-                {Resource::Fish, 1}
+                {Resource::Steel, 1}
             })));
             // expect still valid
             EXPECT_TRUE(cons.isValidNetwork(net));
@@ -64,7 +64,7 @@ namespace ConstraintsTest {
             // add extra
             net.addFactory(Factory(13, 12, ResourceList({
                 {Resource::Copper, -1}, 
-                {Resource::Fish, -1}
+                {Resource::Steel, -1}
             })));
             // expect still valid
             EXPECT_FALSE(cons.isValidNetwork(net));
@@ -181,4 +181,37 @@ namespace ConstraintsTest {
             EXPECT_FALSE(cons.checkTwice(net));
         }
     }
+
+    /////////////////
+    // quickCheck
+    /////////////////
+
+    TEST(ConstraintsTest, QuickCheck_EmptyNet){
+        EXPECT_TRUE(cons.quickCheck(Network()));
+    }
+
+    TEST(ConstraintsTest, QuickCheck_MatchesFullCheck){
+        for(Network net : CANON_NETS) {
+            std::vector<FactoryKey> keys;
+            for (auto fact_it = net.factCBegin(); fact_it != net.factCEnd(); fact_it++)
+                keys.push_back(fact_it->first);
+            EXPECT_EQ(cons.quickCheck(net), cons.isValidSolution(net));
+            // random edits, some of which fail
+            for(int i = 0; i < 200; i++) {
+                FactoryKey a = keys[rand() % keys.size()], b = keys[rand() % keys.size()];
+                ResourceList rl, rl_back;
+                Resource res = Resource(rand() % int(Resource::COUNT));
+                rl[res] = rand() % 5 - 2;
+                rl_back[res] = -rl[res];
+                switch(rand() % 5) {
+                    case 0: net.addRoute(a, b, rl, rl_back); break;
+                    case 1: if(net.getNumRoutes()) net.addStop(rand() % net.getNumRoutes(), a, 0, rl); break;
+                    case 2: if(net.getNumRoutes()) net.dropStop(rand() % net.getNumRoutes(), a); break;
+                    case 3: if(net.getNumRoutes()) net.setStopCommand(rand() % net.getNumRoutes(), 0, rl); break;
+                    case 4: if(net.getNumRoutes()) net.eraseRoute(rand() % net.getNumRoutes()); break;
+                }
+                EXPECT_EQ(cons.quickCheck(net), cons.isValidSolution(net));
+            }
+        }
+    }
 }
\ No newline at end of file
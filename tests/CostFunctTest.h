@@ -3,6 +3,7 @@
 #include "../headers/solutions/CanonicalExamples.h"
 
 #include <iostream>
+#include <random>
 #include <vector>
 
 // size_t getNumJunctions(const Network& net) const;
@@ -186,4 +187,297 @@ namespace CostFunctTest {
             ALL_COSTS.weights[CostFunct::Metric::TotalPeakCapacity]*8
         );
     }
+
+    /////////////////
+    // incremental evaluation
+    /////////////////
+
+    // network with three overlapping routes, as in CanonDualResProduce
+    Network dualResRoutes() {
+        Network net(CANON_DUAL_RES_PRODUCE);
+        Location a(0, 0), b(2, 1), c(1, 2);
+        net.addRoute((PairList<FactoryKey, ResourceList>){
+            {a, ResourceList({{Resource::Copper, -1}})},
+            {b, ResourceList({{Resource::Copper, 1}})}
+        });
+        net.addRoute((PairList<FactoryKey, ResourceList>){
+            {a, ResourceList({{Resource::Iron, -1}})},
+            {c, ResourceList({{Resource::Iron, 1}})}
+        });
+        net.addRoute((PairList<FactoryKey, ResourceList>){
+            {a, ResourceList({{Resource::Copper, -1}, {Resource::Iron, -1}})},
+            {b, ResourceList({{Resource::Copper, 1}})},
+            {c, ResourceList({{Resource::Iron, 1}})}
+        });
+        return net;
+    }
+
+    TEST(CostFunctTest, Cache_MatchesFull) {
+        Network net = dualResRoutes();
+        CostFunct::CostCache cache = ALL_COSTS.buildCache(net);
+        EXPECT_DOUBLE_EQ(ALL_COSTS(cache), ALL_COSTS(net));
+        EXPECT_EQ(cache.routes.size(), net.getNumRoutes());
+    }
+
+    TEST(CostFunctTest, MetricValues) {
+        Network net = dualResRoutes();
+        std::array<double, CostFunct::Metric::COUNT> values = ALL_COSTS.getMetricValues(net);
+        EXPECT_EQ(values[CostFunct::NumRoutes], net.getNumRoutes());
+        EXPECT_DOUBLE_EQ(values[CostFunct::MaxLength], ALL_COSTS.getMaxLength(net).toDouble());
+        EXPECT_DOUBLE_EQ(values[CostFunct::TotalCarryTime], ALL_COSTS.getTotalCarryTime(net));
+        Cost total = 0;
+        for(size_t m = 0; m < CostFunct::Metric::COUNT; m++)
+            total += values[m] * ALL_COSTS.weights[m];
+        EXPECT_EQ(total, ALL_COSTS(net));
+        EXPECT_STREQ(metricName(CostFunct::MaxPeakCapacity), "MaxPeakCapacity");
+        EXPECT_THROW(metricName(CostFunct::Metric::COUNT), std::out_of_range);
+
+        CostFunct::Metric m;
+        EXPECT_TRUE(parseMetric("maxlength", m));
+        EXPECT_EQ(m, CostFunct::MaxLength);
+        EXPECT_TRUE(parseMetric("total_carry_time", m));
+        EXPECT_EQ(m, CostFunct::TotalCarryTime);
+        EXPECT_FALSE(parseMetric("Max", m));
+    }
+
+    TEST(CostFunctTest, Delta_Erase) {
+        Network net = dualResRoutes();
+        CostFunct::CostCache cache = ALL_COSTS.buildCache(net);
+        for(RouteKey k = 0; k < net.getNumRoutes(); k++) {
+            Network nn(net);
+            nn.eraseRoute(k);
+            NetworkEdit edit;
+            edit.erased.push_back(k);
+            EXPECT_DOUBLE_EQ(ALL_COSTS.delta(cache, edit), ALL_COSTS(nn) - ALL_COSTS(net));
+            // delta does not change the cache
+            EXPECT_DOUBLE_EQ(ALL_COSTS(cache), ALL_COSTS(net));
+        }
+    }
+
+    TEST(CostFunctTest, Delta_ReverseRotate) {
+        Network net = dualResRoutes();
+        CostFunct::CostCache cache = ALL_COSTS.buildCache(net);
+        Network nn(net);
+        nn.reverseRoute(2);
+        nn.rotateRoute(1);
+        NetworkEdit edit;
+        edit.replaced.emplace_back(2, nn.getRoute(2));
+        edit.replaced.emplace_back(1, nn.getRoute(1));
+        EXPECT_DOUBLE_EQ(ALL_COSTS(net) + ALL_COSTS.delta(cache, edit), ALL_COSTS(nn));
+        EXPECT_DOUBLE_EQ(ALL_COSTS.apply(cache, edit), ALL_COSTS(nn));
+        EXPECT_DOUBLE_EQ(ALL_COSTS(cache), ALL_COSTS(nn));
+    }
+
+    TEST(CostFunctTest, Apply_Sequence) {
+        Network net = dualResRoutes();
+        CostFunct::CostCache cache = ALL_COSTS.buildCache(net);
+        // drop the loop route, then add it back at the end
+        Route loop = net.getRoute(2);
+        NetworkEdit drop;
+        drop.erased.push_back(2);
+        net.eraseRoute(2);
+        EXPECT_DOUBLE_EQ(ALL_COSTS.apply(cache, drop), ALL_COSTS(net));
+        EXPECT_EQ(
+            ALL_COSTS.buildCache(net).edge_mult,
+            cache.edge_mult
+        );
+        // drop the copper route and add the loop route in its place
+        NetworkEdit swap;
+        swap.erased.push_back(0);
+        swap.added.push_back(loop);
+        net.eraseRoute(0);
+        net.addRoute(loop);
+        EXPECT_DOUBLE_EQ(ALL_COSTS.apply(cache, swap), ALL_COSTS(net));
+        EXPECT_EQ(cache.routes.size(), net.getNumRoutes());
+        EXPECT_EQ(ALL_COSTS.buildCache(net).edge_mult, cache.edge_mult);
+    }
+
+    // a long run of random edits scores exactly what evaluating the
+    // edited network from scratch does, so the cache doesn't drift
+    TEST(CostFunctTest, Apply_ManyEdits) {
+        std::mt19937 rng(7);
+        Network net;
+        std::vector<FactoryKey> places;
+        for(Coord i = 0; i < 24; i++) {
+            Location loc(i * 7 % 53, i * 11 % 37);
+            // even places supply, odd places take
+            Quant q = (i % 2 == 0) ? 100000 : -100000;
+            net.addFactory(loc, ResourceList({{Resource::Iron, q}, {Resource::Copper, q}}));
+            places.push_back(loc);
+        }
+        // a route of 2 to 5 stops, each command has the sign of its place
+        auto randomRoute = [&]() {
+            PairList<FactoryKey, ResourceList> stops;
+            size_t n = 2 + rng() % 4;
+            for(size_t s = 0; s < n; s++) {
+                size_t p = rng() % places.size();
+                Resource r = (rng() % 2) ? Resource::Iron : Resource::Copper;
+                Quant q = Quant(1 + rng() % 9);
+                stops.push_back({places[p], ResourceList({{r, (p % 2 == 0) ? q : -q}})});
+            }
+            return Route(stops);
+        };
+        for(int i = 0; i < 10; i++)
+            ASSERT_TRUE(net.addRoute(randomRoute()));
+
+        CostFunct::CostCache cache = ALL_COSTS.buildCache(net);
+        for(int step = 0; step < 500; step++) {
+            NetworkEdit edit;
+            RouteKey replaced = RouteKey(rng() % net.getNumRoutes());
+            Network nn(net);
+            if(rng() % 2) {
+                nn.reverseRoute(replaced);
+            } else {
+                nn.rotateRoute(replaced, 1 + rng() % 3);
+            }
+            edit.replaced.emplace_back(replaced, nn.getRoute(replaced));
+            // erase one of the other routes, or add one, keeping 5 to 20 routes
+            if(nn.getNumRoutes() > 5 && rng() % 2) {
+                RouteKey erased = RouteKey(rng() % nn.getNumRoutes());
+                if(erased != replaced) {
+                    nn.eraseRoute(erased);
+                    edit.erased.push_back(erased);
+                }
+            }
+            if(nn.getNumRoutes() < 20 && rng() % 2) {
+                Route added = randomRoute();
+                if(nn.addRoute(added))
+                    edit.added.push_back(added);
+            }
+
+            Cost expected = ALL_COSTS(nn);
+            EXPECT_DOUBLE_EQ(ALL_COSTS(net) + ALL_COSTS.delta(cache, edit), expected);
+            ASSERT_EQ(ALL_COSTS.apply(cache, edit), expected) << "step " << step;
+            ASSERT_EQ(ALL_COSTS(cache), expected);
+            net = nn;
+        }
+    }
+
+    // the edge table is reused between evaluations, a smaller network
+    // must not see the edges of a bigger one evaluated before it
+    TEST(CostFunctTest, TrackLengths_Reused) {
+        Network net = dualResRoutes();
+        CostFunct::CostCache cache = ALL_COSTS.buildCache(net);
+        Dist base, shared;
+        ALL_COSTS.getTrackLengths(net, base, shared);
+        EXPECT_EQ(base, cache.base_track);
+        EXPECT_EQ(shared, cache.shared_track);
+
+        Dist from_map = {0, 0};
+        for(const std::pair<const size_t, Dist>& tl : ALL_COSTS.getTrackLengthMap(net))
+            from_map += tl.second;
+        EXPECT_EQ(from_map, base);
+
+        Network nn(net);
+        nn.eraseRoute(2);
+        nn.eraseRoute(1);
+        ALL_COSTS.getTrackLengths(nn, base, shared);
+        EXPECT_EQ(base, ALL_COSTS.buildCache(nn).base_track);
+        EXPECT_EQ(shared, ((Dist){0, 0}));
+        EXPECT_EQ(ALL_COSTS.getTrackLengthMap(nn).size(), 1);
+    }
+
+    /////////////////
+    // undirected track
+    /////////////////
+
+    CostFunct undirectedCosts() {
+        CostFunct cost = ALL_COSTS;
+        cost.undirected_track = true;
+        return cost;
+    }
+
+    // the two zones routes run out and back over the same junctions
+    TEST(CostFunctTest, Undirected_TwoZones) {
+        Network net(CANON_TWO_ZONES);
+        Location locaR(0, 0),  locbR(0, 2), 
+                 locaL(100, 0),locbL(100, 2),
+                 locjR(1, 1),  locjL(99, 1);
+        EXPECT_TRUE(net.createJunct(locjR)); 
+        EXPECT_TRUE(net.createJunct(locjL));
+        Dist daR = dist(locaR, locjR), daL = dist(locaL, locjL), 
+             dbR = dist(locbR, locjR), dbL = dist(locbL, locjL),
+             dJ  = dist(locjR, locjL);
+        EXPECT_TRUE(net.addRoute((PairList<FactoryKey, ResourceList>){
+            {locaR, net.getPlace(locaR).getBaseQuants()},
+            {locjR, ResourceList()},
+            {locjL, ResourceList()},
+            {locaL, net.getPlace(locaL).getBaseQuants()},
+            {locjL, ResourceList()},
+            {locjR, ResourceList()}
+        }));
+        EXPECT_TRUE(net.addRoute((PairList<FactoryKey, ResourceList>){
+            {locbR, net.getPlace(locbR).getBaseQuants()},
+            {locjR, ResourceList()},
+            {locjL, ResourceList()},
+            {locbL, net.getPlace(locbL).getBaseQuants()},
+            {locjL, ResourceList()},
+            {locjR, ResourceList()}
+        }));
+
+        // every spur is run twice, the junction link four times
+        CostFunct undirected = undirectedCosts();
+        EXPECT_EQ(
+            undirected.getTrackLengthMap(net),
+            ((std::map<size_t, Dist>){
+                {2, daR + daL + dbR + dbL},
+                {4, dJ}
+            })
+        );
+        Dist base, shared;
+        undirected.getTrackLengths(net, base, shared);
+        EXPECT_EQ(base, daR + daL + dbR + dbL + dJ);
+        EXPECT_EQ(shared, daR + daL + dbR + dbL + dJ+dJ+dJ);
+
+        // the rest of the cost is unchanged
+        Cost directed_track = ALL_COSTS.weights[CostFunct::Metric::BaseTrackLength]*(daR+daR + daL+daL + dbR+dbR + dbL+dbL + dJ+dJ).toDouble() + 
+                              ALL_COSTS.weights[CostFunct::Metric::SharedTrackLength]*(dJ + dJ).toDouble();
+        Cost undirected_track = ALL_COSTS.weights[CostFunct::Metric::BaseTrackLength]*base.toDouble() + 
+                                ALL_COSTS.weights[CostFunct::Metric::SharedTrackLength]*shared.toDouble();
+        EXPECT_NEAR(undirected(net) - ALL_COSTS(net), undirected_track - directed_track, 1e-9);
+        EXPECT_LT(undirected(net), ALL_COSTS(net));
+        EXPECT_DOUBLE_EQ(undirected(undirected.buildCache(net)), undirected(net));
+    }
+
+    // a route for each pair of the cycle shares track with the route around it
+    // run the other way
+    TEST(CostFunctTest, Undirected_TriCycle) {
+        Network net(CANON_TRI_CYCLE);
+        Location a(0, 0), b(2, 1), c(1, 2);
+        Dist dab = dist(a, b), dbc = dist(b, c), dca = dist(c, a);
+        // around the cycle a -> c -> b, and back the other way
+        EXPECT_TRUE(net.addRoute((PairList<FactoryKey, ResourceList>){
+            {a, net.getPlace(a).getBaseQuants()},
+            {c, net.getPlace(c).getBaseQuants()},
+            {b, net.getPlace(b).getBaseQuants()}
+        }));
+        EXPECT_TRUE(net.addRoute(std::vector<FactoryKey>{a, b, c}, std::vector<ResourceList>(3, ResourceList())));
+
+        // directed, the two routes have no track in common
+        EXPECT_EQ(
+            ALL_COSTS.getTrackLengthMap(net),
+            ((std::map<size_t, Dist>){{1, dab+dab + dbc+dbc + dca+dca}})
+        );
+
+        CostFunct undirected = undirectedCosts();
+        EXPECT_EQ(
+            undirected.getTrackLengthMap(net),
+            ((std::map<size_t, Dist>){{2, dab + dbc + dca}})
+        );
+        Dist base, shared;
+        undirected.getTrackLengths(net, base, shared);
+        EXPECT_EQ(base, dab + dbc + dca);
+        EXPECT_EQ(shared, dab + dbc + dca);
+        EXPECT_LT(undirected(net), ALL_COSTS(net));
+
+        // the cache agrees after dropping the backwards route
+        CostFunct::CostCache cache = undirected.buildCache(net);
+        EXPECT_DOUBLE_EQ(undirected(cache), undirected(net));
+        Network nn(net);
+        nn.eraseRoute(1);
+        NetworkEdit edit;
+        edit.erased.push_back(1);
+        EXPECT_DOUBLE_EQ(undirected.apply(cache, edit), undirected(nn));
+        EXPECT_EQ(cache.edge_mult, undirected.buildCache(nn).edge_mult);
+    }
 }
\ No newline at end of file
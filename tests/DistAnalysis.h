@@ -0,0 +1,54 @@
+/*
+Dist Analysis
+
+Times sorting a large set of Dists with the exact integer comparison
+against sorting them by toDouble, which is how they used to be
+ordered, and counts the pairs the two disagree on.
+*/
+
+/////////////////
+// Includes
+/////////////////
+
+#include <gtest/gtest.h>
+#include "../headers/data/Location.h"
+
+#include<algorithm>
+#include<chrono>
+#include<iostream>
+#include<random>
+
+/////////////////
+// tests
+/////////////////
+
+namespace DistAnalysis {
+    const size_t NUM_DISTS = 2000000;
+
+    TEST(DistAnalysis, ExactVsDouble) {
+        std::mt19937 gen(11);
+        std::uniform_int_distribution<Coord> coord(0, 100000);
+        std::vector<Dist> dists(NUM_DISTS);
+        for(Dist& d : dists)
+            d = {coord(gen), coord(gen)};
+        std::vector<Dist> exact = dists, by_double = dists;
+
+        auto start = std::chrono::high_resolution_clock::now();
+        std::sort(exact.begin(), exact.end());
+        auto mid = std::chrono::high_resolution_clock::now();
+        std::sort(by_double.begin(), by_double.end(), [](const Dist& a, const Dist& b) {
+            return a.toDouble() < b.toDouble();
+        });
+        auto end = std::chrono::high_resolution_clock::now();
+
+        // neighbours the double ordering puts the wrong way round
+        size_t misordered = 0;
+        for(size_t i = 1; i < by_double.size(); i++)
+            misordered += by_double[i] < by_double[i-1];
+        EXPECT_TRUE(std::is_sorted(exact.begin(), exact.end()));
+
+        std::cout << "Exact sort: " + std::to_string((mid - start).count()) << std::endl;
+        std::cout << "Double sort: " + std::to_string((end - mid).count()) << std::endl;
+        std::cout << "Misordered by double: " << misordered << std::endl;
+    }
+}
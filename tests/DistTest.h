@@ -2,6 +2,8 @@
 #include "../headers/data/Location.h"
 #include "TestSetup.h"
 #include <random>
+#include <array>
+#include <cmath>
 
 TEST(DistTest, NoDist) {
     EXPECT_EQ(dist((Location){0, 0}, (Location){0, 0}), ((Dist){0, 0}));
@@ -40,4 +42,41 @@ TEST(DistTest, ConverseDistEqual) {
         EXPECT_EQ(dist(prev, temp), dist(temp, prev));
         prev = temp;
     }
-}
\ No newline at end of file
+}
+// long double has enough precision to order Dists whose lengths are far apart
+TEST(DistTest, CompareMatchesDouble) {
+    std::mt19937 gen(7);
+    std::uniform_int_distribution<Coord> coord(0, 1 << 20);
+    for(int i = 0; i < 100000; i++) {
+        Dist a = {coord(gen), coord(gen)}, b = {coord(gen), coord(gen)};
+        long double la = a.rat_ + a.irrat_ * sqrtl(2), lb = b.rat_ + b.irrat_ * sqrtl(2);
+        if(fabsl(la - lb) < 1e-6)
+            continue;
+        EXPECT_EQ(a < b, la < lb);
+        EXPECT_EQ(a > b, la > lb);
+        EXPECT_EQ(a.compare(b), la < lb ? -1 : 1);
+        EXPECT_EQ((a - b) == (b - a), true);
+    }
+}
+
+// p/q from the Pell equation p^2 - 2q^2 = +-1 are the closest a
+// rational length can get to a diagonal one. The largest pairs differ by
+// less than a double's rounding error.
+TEST(DistTest, CompareNearlyEqual) {
+    // {p, q, p^2 - 2q^2}
+    std::vector<std::array<int64_t, 3>> pell = {
+        {3, 2, 1}, {99, 70, 1}, {8119, 5741, -1}, {665857, 470832, 1},
+        {54608393, 38613965, -1}, {768398401, 543339720, 1}, {1855077841, 1311738121, -1}
+    };
+    for(const auto& p : pell) {
+        Dist straight = {Coord(p[0]), 0}, diagonal = {0, Coord(p[1])};
+        EXPECT_EQ(straight > diagonal, p[2] > 0);
+        EXPECT_EQ(straight < diagonal, p[2] < 0);
+        EXPECT_EQ(straight.compare(diagonal), p[2] > 0 ? 1 : -1);
+        EXPECT_EQ(diagonal.compare(straight), p[2] > 0 ? -1 : 1);
+        // both ways round, the difference is positive
+        EXPECT_EQ(straight - diagonal, diagonal - straight);
+        EXPECT_GT(straight - diagonal, ((Dist){0, 0}));
+    }
+    EXPECT_EQ(((Dist){5, 7}).compare((Dist){5, 7}), 0);
+}
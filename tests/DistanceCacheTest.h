@@ -0,0 +1,45 @@
+#include <gtest/gtest.h>
+#include "../headers/data/DistanceCache.h"
+#include "TestSetup.h"
+
+namespace DistanceCacheTest {
+    std::vector<Location> randomLocs(size_t n) {
+        std::vector<Location> locs;
+        for(size_t i = 0; i < n; i++)
+            locs.push_back(Location(MIN_LOC_COORD + rand() % (MAX_LOC_COORD - MIN_LOC_COORD),
+                                    MIN_LOC_COORD + rand() % (MAX_LOC_COORD - MIN_LOC_COORD)));
+        return locs;
+    }
+
+    void expectMatchesDist(const DistanceCache& cache, const std::vector<Location>& locs) {
+        ASSERT_EQ(cache.size(), locs.size());
+        for(size_t a = 0; a < locs.size(); a++)
+            for(size_t b = 0; b < locs.size(); b++)
+                EXPECT_EQ(cache.get(a, b), dist(locs[a], locs[b]));
+    }
+
+    TEST(DistanceCacheTest, Empty) {
+        DistanceCache cache;
+        EXPECT_EQ(cache.size(), 0);
+        EXPECT_EQ(cache.tableBytes(), 0);
+        DistanceCache one({Location(3, 4)});
+        EXPECT_EQ(one.get(0, 0), ((Dist){0, 0}));
+    }
+
+    TEST(DistanceCacheTest, Precomputed) {
+        std::vector<Location> locs = randomLocs(200);
+        DistanceCache cache(locs);
+        EXPECT_TRUE(cache.isPrecomputed());
+        EXPECT_EQ(cache.tableBytes(), 200 * 199 / 2 * sizeof(Dist));
+        expectMatchesDist(cache, locs);
+    }
+
+    // over the memory cap, distances are computed when asked for
+    TEST(DistanceCacheTest, OverCap) {
+        std::vector<Location> locs = randomLocs(200);
+        DistanceCache cache(locs, 1000);
+        EXPECT_FALSE(cache.isPrecomputed());
+        EXPECT_EQ(cache.tableBytes(), 0);
+        expectMatchesDist(cache, locs);
+    }
+}
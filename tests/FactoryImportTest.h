@@ -0,0 +1,117 @@
+/*
+FactoryImport unit test
+
+This file tests reading factory files into networks with the
+FactoryImporter, defined in FactoryImport.h
+*/
+
+/////////////////
+// Includes
+/////////////////
+
+#include <gtest/gtest.h>
+#include "../headers/solutions/FactoryImport.h"
+#include <sstream>
+
+/////////////////
+// tests
+/////////////////
+
+namespace FactoryImportTest {
+    Network importText(const std::string& text, bool validate = true) {
+        std::istringstream in(text);
+        FactoryImporter importer;
+        importer.read(in);
+        return importer.toNetwork(validate);
+    }
+
+    TEST(FactoryImportTest, Csv) {
+        Network net = importText(
+            "x,y,resource,quant\n"
+            "# furnaces\n"
+            "0,0,Copper,5\n"
+            "\n"
+            "10, -3, copper-plate, -5, steel_plate, 2\n"
+            "4,4\r\n"
+            "-7,2,steel,-2");
+        EXPECT_EQ(net.getNumFactories(), 3);
+        EXPECT_EQ(net.getNumJunctions(), 1);
+        EXPECT_EQ(net.getPlace(Location(0,0)).getBaseQuants(), ResourceList({{Resource::Copper, 5}}));
+        EXPECT_EQ(net.getPlace(Location(10,-3)).getBaseQuants(), ResourceList({{Resource::Copper, -5}, {Resource::Steel, 2}}));
+        EXPECT_EQ(net.getPlace(Location(-7,2)).getBaseQuants(), ResourceList({{Resource::Steel, -2}}));
+        EXPECT_TRUE(net.hasPlace(Location(4,4)));
+    }
+
+    TEST(FactoryImportTest, JsonLines) {
+        Network net = importText(
+            "{\"x\": 1, \"y\": 2, \"name\": \"smelter 1\", \"resources\": {\"iron-plate\": 30, \"Steel\": 4}}\n"
+            "{\"y\": -2, \"x\": 3, \"items\": {\"iron\": -30, \"steel\": -4}, \"active\": true}\n"
+            "{\"x\": 5, \"y\": 5}\n");
+        EXPECT_EQ(net.getNumFactories(), 2);
+        EXPECT_EQ(net.getNumJunctions(), 1);
+        EXPECT_EQ(net.getPlace(Location(1,2)).getBaseQuants(), ResourceList({{Resource::Iron, 30}, {Resource::Steel, 4}}));
+        EXPECT_EQ(net.getPlace(Location(3,-2)).getBaseQuants(), ResourceList({{Resource::Iron, -30}, {Resource::Steel, -4}}));
+    }
+
+    // rows at the same place add up
+    TEST(FactoryImportTest, MergeRows) {
+        std::istringstream in(
+            "1,1,iron,3\n"
+            "2,2,iron,-5\n"
+            "{\"x\": 1, \"y\": 1, \"resources\": {\"iron\": 2}}\n");
+        FactoryImporter importer;
+        importer.read(in);
+        EXPECT_EQ(importer.getNumLines(), 3);
+        EXPECT_EQ(importer.getNumRows(), 3);
+        EXPECT_EQ(importer.getNumPlaces(), 2);
+        Network net = importer.toNetwork();
+        EXPECT_EQ(net.getPlace(Location(1,1)).getBaseQuants(), ResourceList({{Resource::Iron, 5}}));
+    }
+
+    // the places don't depend on where the chunks split the lines
+    TEST(FactoryImportTest, Chunks) {
+        std::string text;
+        for(int i = 0; i < 200; i++)
+            text += std::to_string(i) + "," + std::to_string(-i) + ",steel," + std::to_string(i % 2 ? 3 : -2) + "\n";
+        Network whole = importText(text);
+        for(size_t chunk : {size_t(1), size_t(7), size_t(64)}) {
+            std::istringstream in(text);
+            FactoryImporter importer;
+            importer.read(in, chunk);
+            Network net = importer.toNetwork();
+            ASSERT_EQ(net.getNumFactories(), whole.getNumFactories());
+            for(auto it = whole.factCBegin(); it != whole.factCEnd(); it++)
+                EXPECT_EQ(net.getPlace(it->first).getBaseQuants(), it->second.getBaseQuants());
+        }
+    }
+
+    TEST(FactoryImportTest, Errors) {
+        EXPECT_THROW(importText("0,0,copper,1\nx,y\n"), std::invalid_argument);      // header after a row
+        EXPECT_THROW(importText("0,0,unobtainium,1\n"), std::invalid_argument);
+        if(Resource::COUNT <= Resource::Gear) {                                       // left out of the catalogue
+            EXPECT_THROW(importText("0,0,iron-gear-wheel,1\n"), std::invalid_argument);
+        }
+        EXPECT_THROW(importText("0,0,copper\n"), std::invalid_argument);
+        EXPECT_THROW(importText("0,0,copper,1.5\n"), std::invalid_argument);
+        EXPECT_THROW(importText("0,0,copper,99999999999\n"), std::invalid_argument);
+        EXPECT_THROW(importText("{\"x\": 1}\n"), std::invalid_argument);
+        EXPECT_THROW(importText("{\"x\": 1, \"y\": 2\n"), std::invalid_argument);
+        EXPECT_THROW(importText("{\"x\": 1, \"y\": 2, \"resources\": [1]}\n"), std::invalid_argument);
+        EXPECT_THROW(FactoryImporter().readFile("no/such/factory/file.csv"), std::runtime_error);
+
+        // the message says which line is wrong
+        try {
+            importText("0,0,copper,1\n\n1,1,copper,oops\n");
+            FAIL();
+        } catch(const std::invalid_argument& e) {
+            EXPECT_NE(std::string(e.what()).find("line 3"), std::string::npos);
+        }
+    }
+
+    // more consumed than produced fails Constraints::isValidNetwork
+    TEST(FactoryImportTest, Validate) {
+        const std::string text = "0,0,copper,2\n1,1,copper,-3\n";
+        EXPECT_THROW(importText(text), std::invalid_argument);
+        EXPECT_EQ(importText(text, false).getNumFactories(), 2);
+    }
+}
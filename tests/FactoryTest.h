@@ -160,4 +160,33 @@ TEST(FactoryTest, deallocate)
     EXPECT_TRUE(factory.deallocate(rl));
     EXPECT_EQ(factory.getUnallocated(), rl);
     EXPECT_EQ(factory.getAllocated(), ResourceList());
-}
\ No newline at end of file
+}
+
+// allocate and deallocate either apply the whole list or leave the factory alone
+TEST(FactoryTest, AllocateAllOrNothing)
+{
+    for(int iter = 0; iter < 1000; iter++)
+    {
+        ResourceList base, rl;
+        for(Resource r = Resource(0); r != Resource::COUNT; r++)
+        {
+            base[r] = rand() % 7 - 3;
+            rl[r] = rand() % 3 ? 0 : rand() % 7 - 3;
+        }
+        Factory factory(0, 0, base);
+        ResourceList before = factory.getUnallocated();
+        // per resource rules
+        bool ok = true;
+        for(Resource r = Resource(0); r != Resource::COUNT; r++)
+            ok &= (rl[r] == 0 || signof(rl[r]) == signof(base[r])) && abs(before[r]) >= abs(rl[r]);
+        EXPECT_EQ(factory.allocate(rl), ok);
+        EXPECT_EQ(factory.getUnallocated(), ok ? before - rl : before);
+        if(ok) {
+            EXPECT_TRUE(factory.deallocate(rl));
+            EXPECT_EQ(factory.getUnallocated(), before);
+        } else {
+            // nothing is allocated yet, so nothing can be given back
+            EXPECT_EQ(factory.deallocate(rl), rl == ResourceList());
+        }
+    }
+}
@@ -54,7 +54,7 @@ namespace GeneticTest {
             // add extra
             net.addFactory(Factory(13, 12, ResourceList({
                 {Resource::Copper, 1}, 
-                {Resource::Fish, 1}
+                {Resource::Steel, 1}
             })));
             Genetic solv(net, ALL_COSTS, CONS, 0);
             EXPECT_TRUE(
@@ -149,7 +149,7 @@ namespace GeneticTest {
             // add extra
             net.addFactory(Factory(13, 12, ResourceList({
                 {Resource::Copper, 1}, 
-                {Resource::Fish, 1}
+                {Resource::Steel, 1}
             })));
             Genetic solv(net, ALL_COSTS, CONS, 0);
             // get working solution with a bunch of routes
@@ -252,6 +252,37 @@ namespace GeneticTest {
             EXPECT_TRUE(ALL_COSTS(solv.solve()) <= init_cost);
         }
     }
+    TEST(GeneticTest, Solve_Threads_Reproducible){
+        // the same seed gives the same solution, whatever the thread count
+        for(const Network& net : CANON_NETS) {
+            Genetic solv(net, ALL_COSTS, CONS, NUM_ITERS);
+            solv.setSeed(1234);
+            Network single = solv.solve();
+            solv.setThreads(4);
+            Network multi = solv.solve();
+            EXPECT_TRUE(CONS(multi));
+            EXPECT_EQ(ALL_COSTS(single), ALL_COSTS(multi));
+            ASSERT_EQ(single.getNumRoutes(), multi.getNumRoutes());
+            for(RouteKey r = 0; r < single.getNumRoutes(); r++)
+                EXPECT_EQ(single.getRoute(r), multi.getRoute(r));
+        }
+    }
+
+    TEST(GeneticTest, Solve_MemoryStats){
+        Genetic plain(CANON_TRI_CYCLE, ALL_COSTS, CONS, NUM_ITERS);
+        Network expected = plain.solve();
+
+        // arenas get their blocks from upstream, so it sees far fewer allocations
+        CountingResource upstream;
+        Genetic solv(CANON_TRI_CYCLE, ALL_COSTS, CONS, NUM_ITERS);
+        solv.setMemoryResource(&upstream);
+        Network solved = solv.solve();
+        MemoryStats stats = solv.getMemoryStats();
+        EXPECT_GT(stats.allocations, 0);
+        EXPECT_LT(stats.upstream_allocations, stats.allocations);
+        EXPECT_EQ(stats.upstream_allocations, upstream.getStats().allocations);
+        EXPECT_EQ(ALL_COSTS(solved), ALL_COSTS(expected));
+    }
 
     /*
     //These tests run long and fail cuz the genetic algorithm is bad
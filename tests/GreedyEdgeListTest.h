@@ -13,6 +13,7 @@ This file tests the Constraints object, defined in Constraints.h
 #include <gtest/gtest.h>
 #include "../headers/solutions/solvers/GreedyEdgeList.h"
 #include "../headers/solutions/CanonicalExamples.h"
+#include <algorithm>
 
 /////////////////
 // tests
@@ -30,6 +31,52 @@ namespace GreedyEdgeListTest {
     };
     Constraints CONS;
 
+    /////////////////
+    // edge list
+    /////////////////
+
+    // exposes the edge sort to the tests
+    class EdgeListSolver : public GreedyEdgeList {
+        public:
+            using GreedyEdgeList::GreedyEdgeList;
+            using Solver::sortFinishEdges;
+    };
+
+    // edges inserted one at a time with a lower_bound, how the edge list used to be built
+    std::vector<Solver::FinishEdge> insertEdges(const std::vector<Solver::FinishEdge>& edges) {
+        std::vector<Solver::FinishEdge> list;
+        for(const Solver::FinishEdge& fe : edges) {
+            auto it = std::lower_bound(list.begin(), list.end(), fe,
+                [](const Solver::FinishEdge& a, const Solver::FinishEdge& b){ return a.prio > b.prio; });
+            list.insert(it, fe);
+        }
+        return list;
+    }
+
+    // sorting once gives the same order as inserting, ties included
+    TEST(GreedyEdgeListTest, SortFinishEdges_Ties){
+        std::vector<Solver::FinishEdge> edges;
+        for(Coord i = 0; i < 40; i++) {
+            Solver::FinishEdge fe;
+            fe.start = Location(i, 0);
+            fe.end = Location(0, i);
+            // few distinct prios, so most edges tie
+            fe.prio = (i * 7) % 3 - 1.5;
+            edges.push_back(fe);
+        }
+        // ties added in one order, then in the other
+        for(int pass = 0; pass < 2; pass++) {
+            std::vector<Solver::FinishEdge> inserted = insertEdges(edges), sorted = edges;
+            EdgeListSolver::sortFinishEdges(sorted);
+            ASSERT_EQ(sorted.size(), inserted.size());
+            for(size_t i = 0; i < sorted.size(); i++) {
+                EXPECT_EQ(sorted[i].start, inserted[i].start) << "pass " << pass << ", edge " << i;
+                EXPECT_EQ(sorted[i].prio, inserted[i].prio);
+            }
+            std::reverse(edges.begin(), edges.end());
+        }
+    }
+
     /////////////////
     // finishNetwork
     /////////////////
@@ -54,7 +101,7 @@ namespace GreedyEdgeListTest {
             // add extra
             net.addFactory(Factory(13, 12, ResourceList({
                 {Resource::Copper, 1}, 
-                {Resource::Fish, 1}
+                {Resource::Steel, 1}
             })));
             GreedyEdgeList solv(net, ALL_COSTS, CONS);
             EXPECT_TRUE(
@@ -98,6 +145,21 @@ namespace GreedyEdgeListTest {
         }
     }
 
+    TEST(GreedyEdgeListTest, FinishNetwork_Neighbourhood){
+        // networks still finish with only a few nearby trading partners
+        for (int f = 2; f < MAX_NET_SIZE; f += 7){
+            Network net = randomNetwork(rand(), f, f*10);
+            GreedyEdgeList solv(net, ALL_COSTS, CONS);
+            solv.setEdgeNeighbourhood(3);
+            solv.generateEdgeList();
+            EXPECT_TRUE(CONS(solv.finishNetwork(solv.getNet())));
+            // and every factory in reach gives every edge
+            solv.setEdgeNeighbourhood(0, (Dist){4*MAX_LOC_COORD, 0});
+            solv.generateEdgeList();
+            EXPECT_TRUE(CONS(solv.finishNetwork(solv.getNet())));
+        }
+    }
+
     // /////////////////
     // // spliceRoutes
     // /////////////////
@@ -149,7 +211,7 @@ namespace GreedyEdgeListTest {
     //         // add extra
     //         net.addFactory(Factory(13, 12, ResourceList({
     //             {Resource::Copper, 1}, 
-    //             {Resource::Fish, 1}
+    //             {Resource::Steel, 1}
     //         })));
     //         GreedyEdgeList solv(net, ALL_COSTS, CONS);
     //         // get working solution with a bunch of routes
@@ -252,7 +314,58 @@ namespace GreedyEdgeListTest {
             EXPECT_TRUE(ALL_COSTS(solv.solve()) <= init_cost);
         }
     }
+    TEST(GreedyEdgeListTest, Solve_Threads_Reproducible){
+        // the same seed gives the same solution, whatever the thread count
+        for (size_t s = 1; s <= 3; s++){
+            Network net = randomNetwork(s, 20, 40);
+            GreedyEdgeList solv(net, ALL_COSTS, CONS, 1.0, 3.0, 16);
+            solv.setSeed(s);
+            Network single = solv.solve();
+            solv.setThreads(4);
+            Network multi = solv.solve();
+            EXPECT_TRUE(CONS(multi));
+            EXPECT_EQ(ALL_COSTS(single), ALL_COSTS(multi));
+            ASSERT_EQ(single.getNumRoutes(), multi.getNumRoutes());
+            for(RouteKey r = 0; r < single.getNumRoutes(); r++)
+                EXPECT_EQ(single.getRoute(r), multi.getRoute(r));
+        }
+    }
+    TEST(GreedyEdgeListTest, Solve_MemoryStats){
+        Network net = randomNetwork(7, 20, 40);
+        GreedyEdgeList plain(net, ALL_COSTS, CONS);
+        Network expected = plain.solve();
+
+        // arenas get their blocks from upstream, so it sees far fewer allocations
+        CountingResource upstream;
+        GreedyEdgeList solv(net, ALL_COSTS, CONS);
+        solv.setMemoryResource(&upstream);
+        Network solved = solv.solve();
+        MemoryStats stats = solv.getMemoryStats();
+        EXPECT_GT(stats.allocations, 0);
+        EXPECT_LT(stats.upstream_allocations, stats.allocations);
+        EXPECT_EQ(stats.upstream_allocations, upstream.getStats().allocations);
+        EXPECT_EQ(stats.upstream_bytes, upstream.getStats().bytes);
+        EXPECT_EQ(ALL_COSTS(solved), ALL_COSTS(expected));
+
+        // stats are for the last solve only
+        solv.solve();
+        EXPECT_EQ(solv.getMemoryStats().allocations, stats.allocations);
+    }
     
+    // a supplier and a consumer of every resource in the catalogue, so the
+    // whole catalogue is carried whatever RESOURCE_COUNT the build uses
+    TEST(GreedyEdgeListTest, Solve_WholeCatalogue){
+        Network net;
+        for(Resource r = Resource(0); r != Resource::COUNT; r++) {
+            net.addFactory(Location(2*r, 0), ResourceList({{r, 3}}));
+            net.addFactory(Location(2*r + 1, 4), ResourceList({{r, -3}}));
+        }
+        GreedyEdgeList solv(net, ALL_COSTS, CONS);
+        Network solved = solv.solve();
+        EXPECT_TRUE(CONS(solved));
+        EXPECT_EQ(solved.getPlace(Location(2*(Resource::COUNT - 1) + 1, 4)).getUnallocated(), ResourceList());
+    }
+
     #include <iostream>
     TEST(GreedyEdgeListTest, Solve_Random_GridSize){
         // check random networks with an increasing grid size and a constant number of factories
@@ -0,0 +1,86 @@
+#include <gtest/gtest.h>
+#include "../headers/data/HashCounter.h"
+#include "TestSetup.h"
+#include <map>
+#include <random>
+
+namespace HashCounterTest {
+    // few distinct hashes, so keys share long probe runs
+    struct CollidingHasher {
+        size_t operator()(int key) const noexcept { return key % 3; }
+    };
+    typedef HashCounter<int, CollidingHasher> Counter;
+
+    void expectMatches(const Counter& counter, const std::map<int, uint32_t>& expected, int max_key) {
+        EXPECT_EQ(counter.size(), expected.size());
+        for(int key = 0; key < max_key; key++) {
+            std::map<int, uint32_t>::const_iterator found = expected.find(key);
+            EXPECT_EQ(counter.count(key), found == expected.end() ? 0 : found->second);
+        }
+        size_t visited = 0;
+        counter.forEach([&](int key, uint32_t n) {
+            EXPECT_EQ(n, expected.at(key));
+            visited++;
+        });
+        EXPECT_EQ(visited, expected.size());
+    }
+
+    TEST(HashCounterTest, AddAndSubtract) {
+        Counter counter;
+        counter.add(4, 2);
+        counter.increment(7);
+        EXPECT_EQ(counter.count(4), 2);
+        EXPECT_EQ(counter.count(7), 1);
+        counter.subtract(4, 1);
+        EXPECT_EQ(counter.count(4), 1);
+        counter.subtract(7, 1);
+        EXPECT_EQ(counter.count(7), 0);
+        EXPECT_EQ(counter.size(), 1);
+        EXPECT_THROW(counter.subtract(7, 1), std::out_of_range);
+        EXPECT_THROW(counter.subtract(4, 2), std::out_of_range);
+        EXPECT_EQ(counter.count(4), 1);
+    }
+
+    // random adds and subtracts agree with a std::map, through removals from
+    // the middle of probe runs and through the table growing
+    TEST(HashCounterTest, MatchesMap) {
+        const int MAX_KEY = 200;
+        std::mt19937 gen(5);
+        Counter counter;
+        std::map<int, uint32_t> expected;
+        for(int step = 0; step < 20000; step++) {
+            int key = gen() % MAX_KEY;
+            if(gen() % 2 && expected.count(key)) {
+                uint32_t n = gen() % expected[key] + 1;
+                counter.subtract(key, n);
+                if((expected[key] -= n) == 0)
+                    expected.erase(key);
+            }
+            else {
+                uint32_t n = gen() % 3 + 1;
+                counter.add(key, n);
+                expected[key] += n;
+            }
+            if(step % 1000 == 0)
+                expectMatches(counter, expected, MAX_KEY);
+        }
+        expectMatches(counter, expected, MAX_KEY);
+    }
+
+    // equal whatever order the keys went in or how big the tables grew
+    TEST(HashCounterTest, Equality) {
+        Counter a, b(1000);
+        for(int key = 0; key < 50; key++)
+            a.increment(key);
+        for(int key = 49; key >= 0; key--)
+            b.increment(key);
+        EXPECT_EQ(a, b);
+        b.increment(50);
+        EXPECT_NE(a, b);
+        b.subtract(50, 1);
+        b.increment(3);
+        EXPECT_NE(a, b);
+        a.increment(3);
+        EXPECT_EQ(a, b);
+    }
+}
@@ -0,0 +1,76 @@
+/*
+Import Analysis
+
+Measures how many rows per second the FactoryImporter reads from a
+generated CSV factory file, and compares building the same places one
+addFactory call at a time, in shuffled order.
+*/
+
+/////////////////
+// Includes
+/////////////////
+
+#include <gtest/gtest.h>
+#include "../headers/solutions/FactoryImport.h"
+
+#include<algorithm>
+#include<chrono>
+#include<fstream>
+#include<iostream>
+#include<random>
+
+/////////////////
+// tests
+/////////////////
+
+namespace ImportAnalysis {
+    const size_t NUM_ROWS = 1000000;
+
+    // NUM_ROWS factories on a grid, each making one resource out of another.
+    // Every resource is made a little faster than it is used, so the network is valid.
+    std::string writeFactoryFile() {
+        std::string path = testing::TempDir() + "ImportAnalysis.csv";
+        std::ofstream out(path);
+        out << "x,y,resource,quant,resource,quant\n";
+        for(size_t i = 0; i < NUM_ROWS; i++) {
+            Resource made = Resource(i % Resource::COUNT), used = Resource((i + 1 + i / 7 % 11) % Resource::COUNT);
+            out << i % 1000 << ',' << i / 1000 << ',' << resourceName(made) << ",6,"
+                << resourceName(used) << ",-5\n";
+        }
+        return path;
+    }
+
+    TEST(ImportAnalysis, RowsPerSecond) {
+        std::string path = writeFactoryFile();
+
+        auto start = std::chrono::high_resolution_clock::now();
+        FactoryImporter importer;
+        importer.readFile(path);
+        auto parsed = std::chrono::high_resolution_clock::now();
+        Network net = importer.toNetwork();
+        auto built = std::chrono::high_resolution_clock::now();
+        EXPECT_EQ(net.getNumFactories(), NUM_ROWS);
+
+        double parse_s = std::chrono::duration<double>(parsed - start).count();
+        double total_s = std::chrono::duration<double>(built - start).count();
+        std::cout << "Parse: " << parse_s * 1000 << "ms" << std::endl;
+        std::cout << "Parse and build: " << total_s * 1000 << "ms" << std::endl;
+        std::cout << "Rows/s: " << NUM_ROWS / total_s << std::endl;
+
+        // the same places added one at a time, out of order so none of them
+        // is simply appended, then iterated in order once
+        std::vector<std::pair<Location, ResourceList>> places;
+        for(auto it = net.factCBegin(); it != net.factCEnd(); it++)
+            places.emplace_back(it->first, it->second.getBaseQuants());
+        std::shuffle(places.begin(), places.end(), std::mt19937(1));
+        start = std::chrono::high_resolution_clock::now();
+        Network slow;
+        for(const std::pair<Location, ResourceList>& place : places)
+            slow.addFactory(place.first, place.second);
+        EXPECT_EQ(slow.getPlaceIds().size(), NUM_ROWS);
+        auto end = std::chrono::high_resolution_clock::now();
+        std::cout << "addFactory: " << std::chrono::duration<double>(end - start).count() * 1000 << "ms" << std::endl;
+        EXPECT_TRUE(std::equal(net.factCBegin(), net.factCEnd(), slow.factCBegin(),
+            [](const auto& a, const auto& b){ return a.first == b.first; }));
+    }
+}
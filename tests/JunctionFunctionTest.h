@@ -102,6 +102,14 @@ namespace JuncitonFunctionTest
     }));
     // good junction points: (6,0) 2x, (12,0) 1x, (0,6) 1x, (0,-6) 1x
 
+    // doubleMul with a junction and a far away factory
+    const Network withJunction(std::vector<Factory>({
+        Factory(0, 0, ResourceList({{Resource::Copper, 1}})),
+        Factory(6, 6, ResourceList({{Resource::Copper, 1}})),
+        Factory(6, -6, ResourceList({{Resource::Copper, 1}})),
+        Factory(3, 1, ResourceList()),
+        Factory(500, 500, ResourceList({{Resource::Copper, 1}}))
+    }));
 
     /////////////////////////////////
     // Tests
@@ -295,4 +303,51 @@ namespace JuncitonFunctionTest
         }
     }
 
-} // namespace 
\ No newline at end of file
+    TEST(JunctionTest, SkipsJunctions)
+    {
+        basicSolver solve(withJunction);
+        std::vector<std::pair<Location, int>> all = solve.junctionFunction(withJunction.getNumFactories()*12);
+        // only pairs of factories within 20 of each other, so the same points as doubleMul
+        std::vector<std::pair<Location, int>> near = solve.junctionFunction(doubleMul.getNumFactories()*12, Dist{20, 0});
+        std::vector<std::pair<Location, int>> expected = basicSolver(doubleMul).junctionFunction(doubleMul.getNumFactories()*12);
+        EXPECT_EQ(near, expected);
+        // the far factory adds points, (6,0) is still counted twice
+        EXPECT_GT(all.size(), near.size());
+        EXPECT_NE(std::find(all.begin(), all.end(), std::make_pair(Location(6,0), 2)), all.end());
+    }
+
+    TEST(JunctionTest, TopK)
+    {
+        for (int iter = 0; iter < 10; iter++)
+        {
+            std::vector<Factory> facts;
+            for (int i = 0; i < 30; i++)
+                facts.push_back(Factory(rand() % 41 - 20, rand() % 41 - 20, ResourceList({{Resource::Copper, 1}})));
+            Network net(facts);
+            basicSolver solve(net);
+            std::vector<std::pair<Location, int>> all = solve.junctionFunction(net.getNumFactories()*net.getNumFactories()*6);
+            // asking for fewer gives the start of the full list
+            size_t k = rand() % 50 + 1;
+            std::vector<std::pair<Location, int>> best = solve.junctionFunction(k);
+            ASSERT_EQ(best.size(), k);
+            for (size_t i = 0; i < k; i++)
+                EXPECT_EQ(best[i], all[i]);
+            // ordered by multiplicity, then location
+            for (size_t i = 1; i < all.size() && all[i].second > 0; i++)
+                EXPECT_TRUE(all[i-1].second > all[i].second || (all[i-1].second == all[i].second && all[i-1].first > all[i].first));
+        }
+    }
+
+    TEST(JunctionTest, Threads_SameOutput)
+    {
+        std::vector<Factory> facts;
+        for (int i = 0; i < 60; i++)
+            facts.push_back(Factory(rand() % 81 - 40, rand() % 81 - 40, ResourceList({{Resource::Copper, 1}})));
+        Network net(facts);
+        basicSolver serial(net), parallel(net);
+        parallel.setThreads(4);
+        EXPECT_EQ(serial.junctionFunction(200), parallel.junctionFunction(200));
+        EXPECT_EQ(serial.junctionFunction(200, Dist{15, 0}), parallel.junctionFunction(200, Dist{15, 0}));
+    }
+
+} // namespace
\ No newline at end of file
@@ -0,0 +1,175 @@
+/*
+NetworkFile unit test
+
+This file tests writing network files and reading them back,
+defined in NetworkFile.h
+*/
+
+/////////////////
+// Includes
+/////////////////
+
+#include <gtest/gtest.h>
+#include "../headers/data/NetworkFile.h"
+#include "../headers/solutions/CanonicalExamples.h"
+#include "TestSetup.h"
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+/////////////////
+// tests
+/////////////////
+
+namespace NetworkFileTest {
+    std::string tempPath(const std::string& name) {
+        return testing::TempDir() + "NetworkFileTest_" + name + ".fnet";
+    }
+
+    // tri cycle with every factory fully supplied by one route
+    Network triCycleWithRoute() {
+        Network net = CANON_TRI_CYCLE;
+        Location a{0, 0}, b{2, 1}, c{1, 2};
+        net.addRoute({a, c, b}, {net.getPlace(a).getBaseQuants(), net.getPlace(c).getBaseQuants(), net.getPlace(b).getBaseQuants()});
+        return net;
+    }
+
+    void expectSameNetwork(const Network& expected, const Network& actual) {
+        ASSERT_EQ(actual.getNumFactories(), expected.getNumFactories());
+        EXPECT_EQ(actual.getNumJunctions(), expected.getNumJunctions());
+        EXPECT_EQ(actual.getNumDeficits(), expected.getNumDeficits());
+        for(auto it = expected.factCBegin(); it != expected.factCEnd(); it++) {
+            ASSERT_TRUE(actual.hasPlace(it->first));
+            Factory fact = actual.getPlace(it->first);
+            EXPECT_EQ(fact.getBaseQuants(), it->second.getBaseQuants());
+            EXPECT_EQ(fact.getUnallocated(), it->second.getUnallocated());
+        }
+        ASSERT_EQ(actual.getNumRoutes(), expected.getNumRoutes());
+        for(RouteKey r = 0; r < expected.getNumRoutes(); r++)
+            EXPECT_TRUE(actual.getRoute(r) == expected.getRoute(r));
+    }
+
+    TEST(NetworkFileTest, RoundTrip_Empty) {
+        std::string path = tempPath("Empty");
+        writeNetworkFile(Network(), path);
+        expectSameNetwork(Network(), readNetworkFile(path));
+    }
+
+    TEST(NetworkFileTest, RoundTrip_Canon) {
+        std::vector<Network> nets = {
+            CANON_BASIC,
+            CANON_DUAL_SERVE,
+            CANON_DUAL_RES_PRODUCE,
+            CANON_TWO_ZONES,
+            triCycleWithRoute()
+        };
+        std::string path = tempPath("Canon");
+        for(const Network& net : nets) {
+            writeNetworkFile(net, path);
+            expectSameNetwork(net, readNetworkFile(path));
+        }
+    }
+
+    TEST(NetworkFileTest, RoundTrip_RandomWithJunctions) {
+        std::string path = tempPath("Random");
+        for(int seed = 0; seed < 10; seed++) {
+            Network net = randomNetwork(seed, 50, 100);
+            net.createJunct(1000, 1000);
+            net.createJunct(-1000, 1000);
+            net.addRoute(Location(1000, 1000), Location(-1000, 1000));
+            writeNetworkFile(net, path);
+            expectSameNetwork(net, readNetworkFile(path));
+        }
+    }
+
+    // the mapped arrays are the places in Location order and the route stops
+    TEST(NetworkFileTest, Mapped) {
+        Network net = triCycleWithRoute();
+        std::string path = tempPath("Mapped");
+        writeNetworkFile(net, path);
+        MappedNetworkFile file(path);
+
+        ASSERT_EQ(file.getNumPlaces(), 3);
+        const std::vector<FactoryId>& ids = net.getPlaceIds();
+        for(size_t i = 0; i < ids.size(); i++) {
+            EXPECT_EQ(file.getPlaceLocs()[i], net.getPlaceLoc(ids[i]));
+            EXPECT_EQ(file.getPlaceBaseQuants()[i], net.getPlaceBaseQuants(ids[i]));
+        }
+
+        ASSERT_EQ(file.getNumRoutes(), 1);
+        const Route& route = net.getRoute(0);
+        ASSERT_EQ(file.getRouteSize(0), route.size());
+        for(size_t i = 0; i < route.size(); i++) {
+            EXPECT_EQ(file.getRouteStops(0)[i], route.stopKeys()[i]);
+            EXPECT_EQ(file.getRouteCommands(0)[i], route.stopCommands()[i]);
+        }
+        EXPECT_THROW(file.getRouteSize(1), std::out_of_range);
+    }
+
+    /////////////////
+    // bad files
+    /////////////////
+
+    std::string readBytes(const std::string& path) {
+        std::ifstream in(path, std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+
+    void writeBytes(const std::string& path, const std::string& bytes) {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out.write(bytes.data(), bytes.size());
+    }
+
+    TEST(NetworkFileTest, Missing) {
+        EXPECT_THROW(MappedNetworkFile(tempPath("DoesNotExist")), std::runtime_error);
+        EXPECT_FALSE(isNetworkFile(tempPath("DoesNotExist")));
+    }
+
+    TEST(NetworkFileTest, IsNetworkFile) {
+        std::string path = tempPath("IsNetworkFile");
+        writeNetworkFile(CANON_BASIC, path);
+        EXPECT_TRUE(isNetworkFile(path));
+        writeBytes(path, "0,0,copper,1\n");
+        EXPECT_FALSE(isNetworkFile(path));
+    }
+
+    TEST(NetworkFileTest, Corrupt) {
+        std::string path = tempPath("Corrupt");
+        writeNetworkFile(triCycleWithRoute(), path);
+        const std::string good = readBytes(path);
+
+        writeBytes(path, "");
+        EXPECT_THROW(MappedNetworkFile{path}, std::invalid_argument);
+
+        std::string bytes = good;
+        bytes[0] = 'X';
+        writeBytes(path, bytes);
+        EXPECT_THROW(MappedNetworkFile{path}, std::invalid_argument);
+
+        bytes = good;
+        bytes[offsetof(NetworkFileHeader, version)]++;
+        writeBytes(path, bytes);
+        EXPECT_THROW(MappedNetworkFile{path}, std::invalid_argument);
+
+        writeBytes(path, good.substr(0, good.size() - 1));
+        EXPECT_THROW(MappedNetworkFile{path}, std::invalid_argument);
+
+        // a route pointing past the stops
+        bytes = good;
+        NetworkFileHeader header;
+        std::memcpy(&header, bytes.data(), sizeof(header));
+        bytes[header.route_starts_offset + sizeof(uint64_t)]++;
+        writeBytes(path, bytes);
+        EXPECT_THROW(MappedNetworkFile{path}, std::invalid_argument);
+
+        // a command its factory can't supply
+        bytes = good;
+        bytes[header.stop_commands_offset]++;
+        writeBytes(path, bytes);
+        MappedNetworkFile file(path);
+        EXPECT_THROW(file.toNetwork(), std::invalid_argument);
+
+        writeBytes(path, good);
+        expectSameNetwork(triCycleWithRoute(), readNetworkFile(path));
+    }
+}
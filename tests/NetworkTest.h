@@ -21,51 +21,15 @@ This contains the Unit tests for the Network class.
 namespace NetworkTest
 {
     const int generalProduction = 1000;
-    const ResourceList makeAll = ResourceList(
-        {
-            {Resource(0), generalProduction},
-            {Resource(1), generalProduction},
-            {Resource(2), generalProduction},
-            {Resource(3), generalProduction},
-            {Resource(4), generalProduction},
-            {Resource(5), generalProduction},
-            {Resource(6), generalProduction},
-            {Resource(7), generalProduction},
-            {Resource(8), generalProduction},
-            {Resource(9), generalProduction},
-            {Resource(10), generalProduction},
-            {Resource(11), generalProduction},
-        });
-    const ResourceList eatAll = ResourceList(
-        {
-            {Resource(0), -generalProduction},
-            {Resource(1), -generalProduction},
-            {Resource(2), -generalProduction},
-            {Resource(3), -generalProduction},
-            {Resource(4), -generalProduction},
-            {Resource(5), -generalProduction},
-            {Resource(6), -generalProduction},
-            {Resource(7), -generalProduction},
-            {Resource(8), -generalProduction},
-            {Resource(9), -generalProduction},
-            {Resource(10), -generalProduction},
-            {Resource(11), -generalProduction},
-        });
-    const ResourceList eatHalf = ResourceList(
-        {
-            {Resource(0), -generalProduction/2},
-            {Resource(1), -generalProduction/2},
-            {Resource(2), -generalProduction/2},
-            {Resource(3), -generalProduction/2},
-            {Resource(4), -generalProduction/2},
-            {Resource(5), -generalProduction/2},
-            {Resource(6), -generalProduction/2},
-            {Resource(7), -generalProduction/2},
-            {Resource(8), -generalProduction/2},
-            {Resource(9), -generalProduction/2},
-            {Resource(10), -generalProduction/2},
-            {Resource(11), -generalProduction/2},
-        });
+    // every resource of the catalogue at q
+    ResourceList allResources(Quant q) {
+        ResourceList rl;
+        rl.fill(q);
+        return rl;
+    }
+    const ResourceList makeAll = allResources(generalProduction);
+    const ResourceList eatAll = allResources(-generalProduction);
+    const ResourceList eatHalf = allResources(-generalProduction/2);
         const Location WA(0,0), ID(3,5), OR(-10,-10), CA(-9, -30), NP(100,6);
 
         const std::vector<Factory> santaStops = {
@@ -369,4 +333,150 @@ namespace NetworkTest
         EXPECT_FALSE(gilgamesh.hasPlace(CA));
         EXPECT_FALSE(gilgamesh.hasPlace(OR));
     }
+
+    TEST(NetworkTest, PlaceIds)
+    {
+        Network enkidu(allStops);
+        // ids iterate in Location order and agree with the iterators
+        const std::vector<FactoryId>& ids = enkidu.getPlaceIds();
+        ASSERT_EQ(ids.size(), allStops.size());
+        auto it = enkidu.factCBegin();
+        for (size_t i = 0; i < ids.size(); i++, it++)
+        {
+            EXPECT_EQ(it.id(), ids[i]);
+            EXPECT_EQ(enkidu.getPlaceLoc(ids[i]), it->first);
+            EXPECT_EQ(enkidu.getPlaceId(it->first), ids[i]);
+            if (i > 0) {EXPECT_TRUE(enkidu.getPlaceLoc(ids[i-1]) < enkidu.getPlaceLoc(ids[i]));}
+        }
+        EXPECT_EQ(enkidu.getPlaceId(Location(1,1)), Network::NO_FACTORY);
+
+        // allocations show up in the table
+        EXPECT_TRUE(enkidu.addRoute(WA, ID, makeAll, eatAll));
+        EXPECT_EQ(enkidu.getPlaceUnallocated(enkidu.getPlaceId(WA)), ResourceList());
+        EXPECT_EQ(enkidu.getPlaceBaseQuants(enkidu.getPlaceId(WA)), makeAll);
+
+        // erasing a place keeps every other place reachable
+        EXPECT_TRUE(enkidu.erasePlace(OR));
+        EXPECT_EQ(enkidu.getPlaceId(OR), Network::NO_FACTORY);
+        EXPECT_EQ(enkidu.getPlaceIds().size(), allStops.size() - 1);
+        for (const Factory& f : allStops)
+        {
+            if (f.getLoc() == OR) {continue;}
+            FactoryId id = enkidu.getPlaceId(f.getLoc());
+            ASSERT_NE(id, Network::NO_FACTORY);
+            EXPECT_EQ(enkidu.getPlaceLoc(id), f.getLoc());
+            EXPECT_EQ(enkidu.getPlaceBaseQuants(id), f.getBaseQuants());
+        }
+    }
+
+    // the Location order is sorted lazily, it has to follow places added
+    // and erased between iterations
+    TEST(NetworkTest, PlaceIdsAfterEdits)
+    {
+        auto sorted = [](const Network& net) {
+            const std::vector<FactoryId>& ids = net.getPlaceIds();
+            for (size_t i = 1; i < ids.size(); i++)
+            {
+                if (!(net.getPlaceLoc(ids[i-1]) < net.getPlaceLoc(ids[i]))) {return false;}
+            }
+            return ids.size() == net.getNumFactories() + net.getNumJunctions();
+        };
+        Network enkidu;
+        enkidu.addFactory(Location(5,5), makeAll);
+        enkidu.addFactory(Location(-1,2), eatAll);
+        EXPECT_TRUE(sorted(enkidu));
+        Network gilgamesh(enkidu);
+        enkidu.createJunct(Location(0,0));
+        enkidu.addFactory(Location(-3,9), makeAll);
+        EXPECT_TRUE(sorted(enkidu));
+        EXPECT_EQ(enkidu.factCBegin()->first, Location(-3,9));
+        EXPECT_TRUE(enkidu.erasePlace(Location(-3,9)));
+        EXPECT_TRUE(sorted(enkidu));
+        EXPECT_EQ(enkidu.factCBegin()->first, Location(-1,2));
+        // the copy keeps its own order
+        EXPECT_EQ(gilgamesh.getPlaceIds().size(), 2);
+        EXPECT_TRUE(sorted(gilgamesh));
+    }
+
+    TEST(NetworkTest, AddRouteUnknownPlace)
+    {
+        Network enkidu(santaStops);
+        // CA is not in the network, so nothing should be allocated at ID
+        EXPECT_FALSE(enkidu.addRoute(ID, CA, makeAll, eatAll));
+        EXPECT_EQ(enkidu.getNumRoutes(), 0);
+        EXPECT_EQ(enkidu.getPlace(ID).getUnallocated(), makeAll);
+    }
+
+    TEST(NetworkTest, CopiesAreIndependent)
+    {
+        Network gilgamesh(allStops);
+        EXPECT_TRUE(gilgamesh.addRoute(allStopsStates));
+        EXPECT_TRUE(gilgamesh.addRoute(WA, NP, ResourceList(), ResourceList()));
+
+        // copies share data until they are edited, edits must not leak between them
+        Network enkidu(gilgamesh);
+        enkidu.reverseRoute(0);
+        EXPECT_TRUE(enkidu.eraseRoute(1));
+        enkidu.createJunct(Location(1,1));
+        EXPECT_EQ(gilgamesh.getRoute(0), allStopsStates);
+        EXPECT_EQ(gilgamesh.getNumRoutes(), 2);
+        EXPECT_FALSE(gilgamesh.hasPlace(Location(1,1)));
+        EXPECT_TRUE(enkidu.hasPlace(Location(1,1)));
+        EXPECT_FALSE(enkidu.getRoute(0) == allStopsStates);
+
+        // allocations are also copied on write
+        Network shamhat(gilgamesh);
+        EXPECT_TRUE(shamhat.eraseRoute(0));
+        EXPECT_EQ(shamhat.getPlace(WA).getUnallocated(), makeAll);
+        EXPECT_EQ(gilgamesh.getPlace(WA).getUnallocated(), ResourceList());
+        EXPECT_TRUE(shamhat.erasePlace(OR));
+        EXPECT_TRUE(gilgamesh.hasPlace(OR));
+        EXPECT_EQ(gilgamesh.getRouteStops(0)[2], OR);
+    }
+
+    TEST(NetworkTest, PlaceDistances)
+    {
+        Network gilgamesh(allStops);
+        for (FactoryId a : gilgamesh.getPlaceIds())
+        {
+            for (FactoryId b : gilgamesh.getPlaceIds())
+            {
+                EXPECT_EQ(gilgamesh.getPlaceDist(a, b), dist(gilgamesh.getPlaceLoc(a), gilgamesh.getPlaceLoc(b)));
+            }
+        }
+
+        // copies share the distances until their places change
+        Network enkidu(gilgamesh);
+        EXPECT_EQ(&enkidu.getDistances(), &gilgamesh.getDistances());
+        enkidu.createJunct(Location(1,1));
+        EXPECT_EQ(enkidu.getDistances().size(), allStops.size() + 1);
+        EXPECT_EQ(gilgamesh.getDistances().size(), allStops.size());
+        FactoryId junct = enkidu.getPlaceId(Location(1,1)), wa = enkidu.getPlaceId(WA);
+        EXPECT_EQ(enkidu.getPlaceDist(junct, wa), dist(Location(1,1), WA));
+    }
+
+    TEST(NetworkTest, ArrayConstructor)
+    {
+        // out of Location order, with a junction
+        std::vector<Location> locs = {Location(3,0), Location(1,1), Location(-2,5)};
+        std::vector<ResourceList> quants = {makeAll, ResourceList(), makeAll};
+        Network gilgamesh(locs.data(), quants.data(), locs.size());
+        EXPECT_EQ(gilgamesh.getNumFactories(), 2);
+        EXPECT_EQ(gilgamesh.getNumJunctions(), 1);
+        for (size_t i = 0; i < locs.size(); i++)
+        {
+            EXPECT_EQ(gilgamesh.getPlace(locs[i]).getBaseQuants(), quants[i]);
+            EXPECT_EQ(gilgamesh.getPlace(locs[i]).getUnallocated(), quants[i]);
+        }
+        const std::vector<FactoryId>& ids = gilgamesh.getPlaceIds();
+        for (size_t i = 1; i < ids.size(); i++)
+        {
+            EXPECT_TRUE(gilgamesh.getPlaceLoc(ids[i-1]) < gilgamesh.getPlaceLoc(ids[i]));
+        }
+        EXPECT_TRUE(gilgamesh.addRoute(Location(3,0), Location(1,1), makeAll));
+
+        locs.push_back(Location(1,1));
+        quants.push_back(makeAll);
+        EXPECT_THROW(Network(locs.data(), quants.data(), locs.size()), std::invalid_argument);
+    }
 }// namespace NetworkTest
\ No newline at end of file
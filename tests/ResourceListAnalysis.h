@@ -0,0 +1,144 @@
+/*
+ResourceList Analysis
+
+Compares Route's dense commands against SparseResourceList commands on
+the build's catalogue (build with RESOURCE_COUNT=60 for a large one),
+where each command only touches a few resources, like the commands in
+generated and real layouts. Prints the bytes of commands per route, and
+the time per route of Route::getCarryTime and of copying a route against
+the same over sparse commands. The solvers copy routes whenever they
+edit a network, so both passes matter.
+*/
+
+/////////////////
+// Includes
+/////////////////
+
+#include <gtest/gtest.h>
+#include "../headers/data/Route.h"
+#include "../headers/data/SparseResourceList.h"
+
+#include<chrono>
+#include<iostream>
+#include<random>
+
+/////////////////
+// tests
+/////////////////
+
+namespace ResourceListAnalysis {
+    const size_t NUM_ROUTES = 20000;
+    const int PASSES = 20;
+
+    struct SparseRoute {
+        std::vector<FactoryKey> keys;
+        std::vector<SparseResourceList> commands;
+    };
+
+    // Route::computeMetrics' carry time and peak capacity over sparse commands.
+    // Only the resources a command sets are added and clamped, and the
+    // carried total is kept as it goes instead of summed over every resource.
+    void sparseCarry(const SparseRoute& route, double& carry_time, Quant& peak_capacity) {
+        const std::vector<SparseResourceList>& commands = route.commands;
+        size_t n = commands.size();
+        ResourceList curr;
+        commands[0].forEach([&](size_t r, Quant q) { if(q > 0) curr[r] += q; });
+        for(size_t i = 1; i < n; i++)
+            commands[i].forEach([&](size_t r, Quant q) { curr[r] = std::max(curr[r] + q, Quant(0)); });
+        commands[0].forEach([&](size_t r, Quant q) { if(q < 0) curr[r] += q; });
+
+        Quant cap = curr.total();
+        commands[0].forEach([&](size_t, Quant q) { if(q > 0) cap += q; });
+        carry_time = 0;
+        peak_capacity = std::max(Quant(0), cap);
+        for(size_t i = 1; i <= n; i++) {
+            size_t end = i % n;
+            carry_time += cap * dist(route.keys[i-1], route.keys[end]).toDouble();
+            cap += commands[end].total();
+            if(end != 0)
+                peak_capacity = std::max(peak_capacity, cap);
+        }
+    }
+
+    // routes of 2 to 8 stops, each command sets 1 to 3 resources
+    std::vector<Route> randomRoutes() {
+        std::mt19937 gen(13);
+        std::uniform_int_distribution<Coord> coord(-1000, 1000);
+        std::vector<Route> routes;
+        for(size_t i = 0; i < NUM_ROUTES; i++) {
+            size_t stops = gen() % 7 + 2;
+            PairList<FactoryKey, ResourceList> init;
+            for(size_t s = 0; s < stops; s++) {
+                ResourceList command;
+                for(size_t a = gen() % 3 + 1; a > 0; a--)
+                    command[gen() % Resource::COUNT] = Quant(gen() % 21) - 10;
+                init.push_back({Location(coord(gen), coord(gen)), command});
+            }
+            routes.push_back(Route(init));
+        }
+        return routes;
+    }
+
+    TEST(ResourceListAnalysis, DenseVsSparse) {
+        std::vector<Route> routes = randomRoutes();
+        std::vector<SparseRoute> sparse(routes.size());
+        size_t stops = 0, dense_bytes = 0, sparse_bytes = 0;
+        for(size_t i = 0; i < routes.size(); i++) {
+            for(Route::const_iterator it = routes[i].cbegin(); it != routes[i].cend(); it++) {
+                sparse[i].keys.push_back(it->first);
+                sparse[i].commands.push_back(SparseResourceList(it->second));
+                const SparseResourceList& command = sparse[i].commands.back();
+                dense_bytes += sizeof(ResourceList);
+                sparse_bytes += sizeof(SparseResourceList);
+                if(command.count() > SparseResourceList::INLINE_CAPACITY)
+                    sparse_bytes += command.count() * sizeof(Quant);
+            }
+            stops += routes[i].size();
+        }
+
+        // the dense pass is the real one, each route's cached metrics are
+        // dropped first by touching a stop
+        std::vector<double> dense_carry(routes.size()), sparse_carry(routes.size());
+        std::vector<Quant> dense_peak(routes.size()), sparse_peak(routes.size());
+        auto start = std::chrono::high_resolution_clock::now();
+        for(int pass = 0; pass < PASSES; pass++)
+            for(size_t i = 0; i < routes.size(); i++) {
+                routes[i][0];
+                dense_carry[i] = routes[i].getCarryTime();
+                dense_peak[i] = routes[i].getPeakCapacity();
+            }
+        auto mid = std::chrono::high_resolution_clock::now();
+        for(int pass = 0; pass < PASSES; pass++)
+            for(size_t i = 0; i < sparse.size(); i++)
+                sparseCarry(sparse[i], sparse_carry[i], sparse_peak[i]);
+        auto end = std::chrono::high_resolution_clock::now();
+        EXPECT_EQ(dense_carry, sparse_carry);
+        EXPECT_EQ(dense_peak, sparse_peak);
+
+        // copies, a sparse list can't be memcpy'd so the commands go in a std::vector
+        size_t copied = 0;
+        auto copy_start = std::chrono::high_resolution_clock::now();
+        for(int pass = 0; pass < PASSES; pass++)
+            for(const Route& route : routes) {
+                Route copy(route);
+                copied += copy.size();
+            }
+        auto copy_mid = std::chrono::high_resolution_clock::now();
+        for(int pass = 0; pass < PASSES; pass++)
+            for(const SparseRoute& route : sparse) {
+                SparseRoute copy(route);
+                copied += copy.commands.size();
+            }
+        auto copy_end = std::chrono::high_resolution_clock::now();
+        EXPECT_EQ(copied, 2 * PASSES * stops);
+
+        double runs = double(PASSES) * routes.size();
+        std::cout << "Resources: " << Resource::COUNT << ", stops per route: " << double(stops) / routes.size() << std::endl;
+        std::cout << "Dense command bytes per route: " << double(dense_bytes) / routes.size() << std::endl;
+        std::cout << "Sparse command bytes per route: " << double(sparse_bytes) / routes.size() << std::endl;
+        std::cout << "Dense getCarryTime: " << std::chrono::duration<double, std::nano>(mid - start).count() / runs << " ns per route" << std::endl;
+        std::cout << "Sparse carry time: " << std::chrono::duration<double, std::nano>(end - mid).count() / runs << " ns per route" << std::endl;
+        std::cout << "Dense copy: " << std::chrono::duration<double, std::nano>(copy_mid - copy_start).count() / runs << " ns per route" << std::endl;
+        std::cout << "Sparse copy: " << std::chrono::duration<double, std::nano>(copy_end - copy_mid).count() / runs << " ns per route" << std::endl;
+    }
+}
@@ -12,6 +12,8 @@ This is the unit test for the Resource enum, and the ResourceList class
 
 #include <gtest/gtest.h>
 #include "../headers/data/ResourceList.h"
+#include "../headers/data/ResourceKernels.h"
+#include "TestSetup.h"
 
 /////////////////
 // Resource tests
@@ -99,6 +101,43 @@ TEST(ResourceTest, PostfixOperatorSubtrationWraparound)
     EXPECT_EQ(a, Resource::COUNT);
 }
 
+// names round trip, and ignore case and separators
+TEST(ResourceTest, Names)
+{
+    for (Resource r = Resource(0); r != Resource::COUNT; r++)
+    {
+        Resource parsed;
+        EXPECT_TRUE(parseResource(resourceName(r), parsed));
+        EXPECT_EQ(parsed, r);
+    }
+    EXPECT_STREQ(resourceName(Resource::Steel), "Steel");
+    EXPECT_THROW(resourceName(Resource::COUNT), std::out_of_range);
+
+    Resource parsed;
+    EXPECT_TRUE(parseResource("IRON", parsed));
+    EXPECT_EQ(parsed, Resource::Iron);
+    if (Resource::COUNT >= Resource::NUM_NAMED_RESOURCES)
+    {
+        EXPECT_TRUE(parseResource("nuclear-fuel", parsed));
+        EXPECT_EQ(parsed, Resource::NuclearFuel);
+        EXPECT_TRUE(parseResource("GEAR", parsed));
+        EXPECT_EQ(parsed, Resource::Gear);
+    }
+    else
+    {
+        // named resources past a small catalogue are unknown
+        EXPECT_THROW(resourceName(Resource::Gear), std::out_of_range);
+        EXPECT_FALSE(parseResource("GEAR", parsed));
+    }
+    EXPECT_FALSE(parseResource("gears", parsed));
+    EXPECT_FALSE(parseResource("", parsed));
+    EXPECT_FALSE(parseResource("COUNT", parsed));
+
+    EXPECT_TRUE(sameName("Iron Plate", "iron-plate"));
+    EXPECT_TRUE(sameName("_", ""));
+    EXPECT_FALSE(sameName("iron", "iron_plate"));
+}
+
 /////////////////
 // ResourceList tests
 /////////////////
@@ -116,6 +155,7 @@ TEST(ResourceListTest, DefaultConstrutor)
 // constructor with arguments
 TEST(ResourceListTest, ArgumentedConstructor)
 {
+    REQUIRE_RESOURCES(Resource::NUM_NAMED_RESOURCES);
     const int TEST_VALUE = 17;
     ResourceList a = ResourceList(
         {
@@ -133,9 +173,10 @@ TEST(ResourceListTest, ArgumentedConstructor)
             {Resource::Gear, TEST_VALUE}
         }
     );
+    // every named resource was set, the unnamed ones of a larger catalogue stay empty
     for (ResourceList::iterator i = a.begin(); i != a.end(); i++)
     {
-        EXPECT_EQ(*i, TEST_VALUE);
+        EXPECT_EQ(*i, i - a.begin() < Resource::NUM_NAMED_RESOURCES ? TEST_VALUE : 0);
     }
 }
 
@@ -148,6 +189,7 @@ TEST(ResourceListTest, IsEmptyTrue)
 
 TEST(ResourceListTest, IsEmptyFalse)
 {
+    REQUIRE_RESOURCES(Resource::NUM_NAMED_RESOURCES);
     const int TEST_VALUE = 17;
     ResourceList a = ResourceList(
         {
@@ -171,6 +213,7 @@ TEST(ResourceListTest, IsEmptyFalse)
 // test allPositive
 TEST(ResourceListTest, AllPositiveTrue)
 {
+    REQUIRE_RESOURCES(Resource::NUM_NAMED_RESOURCES);
     const int TEST_VALUE = 17;
     ResourceList a = ResourceList(
         {
@@ -193,6 +236,7 @@ TEST(ResourceListTest, AllPositiveTrue)
 
 TEST(ResourceListTest, AllPositiveFalse)
 {
+    REQUIRE_RESOURCES(Resource::NUM_NAMED_RESOURCES);
     const int TEST_VALUE = -17;
     ResourceList a = ResourceList(
         {
@@ -216,6 +260,7 @@ TEST(ResourceListTest, AllPositiveFalse)
 // test getNegative
 TEST(ResourceListTest, GetNegative)
 {
+    REQUIRE_RESOURCES(Resource::NUM_NAMED_RESOURCES);
     const int TEST_VALUE = 17;
     ResourceList a = ResourceList(
         {
@@ -239,6 +284,7 @@ TEST(ResourceListTest, GetNegative)
 // test getPositive
 TEST(ResourceListTest, GetPositive)
 {
+    REQUIRE_RESOURCES(Resource::NUM_NAMED_RESOURCES);
     const int TEST_VALUE = 17;
     ResourceList a(
         {
@@ -262,6 +308,7 @@ TEST(ResourceListTest, GetPositive)
 // test getNegative
 TEST(ResourceListTest, GetNegativeList)
 {
+    REQUIRE_RESOURCES(Resource::NUM_NAMED_RESOURCES);
     const int TEST_VALUE = 17;
     ResourceList a(
         {
@@ -294,6 +341,7 @@ TEST(ResourceListTest, GetNegativeList)
 // test getPositive
 TEST(ResourceListTest, GetPositiveList)
 {
+    REQUIRE_RESOURCES(Resource::NUM_NAMED_RESOURCES);
     const int TEST_VALUE = 17;
     ResourceList a(
         {
@@ -367,6 +415,7 @@ TEST(ResourceListTest, EqualOperatorFalse)
 // test operator+
 TEST(ResourceListTest, AddTwoLists)
 {
+    REQUIRE_RESOURCES(Resource::NUM_NAMED_RESOURCES);
     const int TEST_VALUE = 17;
     ResourceList a = ResourceList(
         {
@@ -399,6 +448,7 @@ TEST(ResourceListTest, AddTwoLists)
 // test operator-
 TEST(ResourceListTest, SubtractTwoLists)
 {
+    REQUIRE_RESOURCES(Resource::NUM_NAMED_RESOURCES);
     const int TEST_VALUE = 17;
     ResourceList a = ResourceList( // [-17,-17,17,17...]
         {
@@ -470,3 +520,83 @@ TEST(ResourceListTest, MinusEqualOperator)
     EXPECT_NE(a, a_copy); // verify a was changed
     EXPECT_EQ(b, b_copy); // verify b was not changed
 }
+
+// test negativeMask and positiveMask
+TEST(ResourceListTest, SignMasks)
+{
+    ResourceList rl;
+    rl[Resource::Copper] = -3;
+    rl[Resource::Iron] = 5;
+    rl[Resource::Steel] = -1;
+    EXPECT_EQ(rl.negativeMask(), (1u << Resource::Copper) | (1u << Resource::Steel));
+    EXPECT_EQ(rl.positiveMask(), 1u << Resource::Iron);
+    EXPECT_EQ(ResourceList().negativeMask() | ResourceList().positiveMask(), 0);
+}
+
+// resources missing from the map are 0
+TEST(ResourceListTest, MapConstructorMissing)
+{
+    ResourceList rl({{Resource::Iron, 4}});
+    for(Resource r = Resource(0); r != Resource::COUNT; r++)
+        EXPECT_EQ(rl[r], r == Resource::Iron ? 4 : 0);
+}
+
+// the last resource of the catalogue, whatever RESOURCE_COUNT the build uses
+TEST(ResourceListTest, WholeCatalogue)
+{
+    Resource last = Resource(Resource::COUNT - 1);
+    EXPECT_EQ(ResourceList().size(), size_t(Resource::COUNT));
+    EXPECT_THROW(ResourceList({{Resource::COUNT, 1}}), std::out_of_range);
+
+    ResourceList a({{Resource::Copper, 2}, {last, -3}}), b({{Resource::Steel, 5}});
+    ResourceList sum = a + b;
+    EXPECT_EQ(sum[last], -3);
+    EXPECT_EQ(sum.total(), 4);
+    EXPECT_EQ(sum.negativeMask(), 1ull << last);
+    EXPECT_EQ(sum.positiveMask(), 1ull | (1ull << Resource::Steel));
+    EXPECT_EQ(sum.getNegative(), std::list<Resource>{last});
+    EXPECT_EQ(sum - b, a);
+    sum.clampNegative();
+    EXPECT_TRUE(sum.allPositive());
+    EXPECT_EQ(sum.getPositiveList(), sum);
+}
+
+// the kernels at widths a build might pick, against plain loops
+template <size_t N>
+void checkKernels()
+{
+    int32_t a[N], b[N], out[N];
+    for (size_t i = 0; i < N; i++)
+    {
+        a[i] = int32_t(rand() % 21 - 10);
+        b[i] = int32_t(rand() % 21 - 10);
+    }
+    ResourceKernels::add<N>(a, b, out);
+    for (size_t i = 0; i < N; i++) {EXPECT_EQ(out[i], a[i] + b[i]);}
+    ResourceKernels::sub<N>(a, b, out);
+    for (size_t i = 0; i < N; i++) {EXPECT_EQ(out[i], a[i] - b[i]);}
+    uint64_t neg = 0, pos = 0;
+    int32_t total = 0;
+    for (size_t i = 0; i < N; i++)
+    {
+        neg |= uint64_t(a[i] < 0) << i;
+        pos |= uint64_t(a[i] > 0) << i;
+        total += a[i];
+    }
+    EXPECT_EQ(ResourceKernels::negativeMask<N>(a), neg);
+    EXPECT_EQ(ResourceKernels::positiveMask<N>(a), pos);
+    EXPECT_EQ(ResourceKernels::sum<N>(a), total);
+    EXPECT_TRUE(ResourceKernels::equal<N>(a, a));
+    b[N-1] = a[N-1] + 1;
+    EXPECT_FALSE(ResourceKernels::equal<N>(a, b));
+    ResourceKernels::clampNegative<N>(a);
+    for (size_t i = 0; i < N; i++) {EXPECT_GE(a[i], 0);}
+}
+
+TEST(ResourceListTest, KernelWidths)
+{
+    checkKernels<Resource::NUM_NAMED_RESOURCES>();
+    checkKernels<13>();
+    checkKernels<60>();
+    checkKernels<64>();
+}
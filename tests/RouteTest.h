@@ -1,5 +1,6 @@
 #include <gtest/gtest.h>
 #include "../headers/data/Route.h"
+#include "TestSetup.h"
 #include <vector>
 #include <exception>
 
@@ -406,6 +407,7 @@ namespace RouteTest
     }
 
     TEST(RouteTest, CapMetricsVariableCap) {
+        REQUIRE_RESOURCES(Resource::NUM_NAMED_RESOURCES);
         const Quant copQ = 2, wireQ = 20, circQ = 1;
         const Location loca(0, 0), locb(0, 3), locc(1, 2), locd(3, 1), loce(4, 0);
         const ResourceList rla({
@@ -513,4 +515,72 @@ namespace RouteTest
         }
     }
 
+    // routes longer than the inline storage, checked against a plain list of stops
+    TEST(RouteTest, LongRouteEdits) {
+        PairList<FactoryKey, ResourceList> expected = {{first, RLCopper}, {second, RLCopperConsume}};
+        Route r(expected);
+        const Location locs[3] = {first, second, third};
+        for(int i = 0; i < 300; i++) {
+            Location loc = locs[rand() % 3];
+            ResourceList rl = rand() % 2 ? RLCopper : RLCopperConsume;
+            size_t pos = rand() % (expected.size() + 2);
+            switch(rand() % 4) {
+                case 0: case 1:
+                    r.addStop(loc, pos, rl);
+                    expected.insert(expected.begin() + std::min(pos, expected.size()), {loc, rl});
+                    break;
+                case 2: {
+                    size_t past = rand() % expected.size();
+                    auto found = std::find_if(expected.begin() + past, expected.end(), [&](const std::pair<FactoryKey, ResourceList>& p) { return p.first == loc; });
+                    bool drop = expected.size() > 2 && found != expected.end();
+                    EXPECT_EQ(r.dropStop(loc, past), drop);
+                    if(drop)
+                        expected.erase(found);
+                    break;
+                }
+                case 3:
+                    r.rotate(pos);
+                    std::rotate(expected.begin(), expected.begin() + pos % expected.size(), expected.end());
+                    break;
+            }
+            ASSERT_EQ(r, Route(expected));
+        }
+        // iterators walk the same stops
+        ASSERT_EQ(r.cend() - r.cbegin(), expected.size());
+        for(size_t i = 0; i < expected.size(); i++) {
+            EXPECT_EQ((r.cbegin() + i)->first, expected[i].first);
+            EXPECT_EQ(r.cbegin()[i].second, expected[i].second);
+            EXPECT_EQ(r.stopKeys()[i], expected[i].first);
+            EXPECT_EQ(r.findStop(expected[i].first), std::find_if(expected.begin(), expected.end(), [&](const std::pair<FactoryKey, ResourceList>& p) { return p.first == expected[i].first; }) - expected.begin());
+        }
+        // copies don't share stops
+        Route copy = r;
+        copy.setResourceList(0, ResourceList());
+        copy.reverse();
+        EXPECT_EQ(r, Route(expected));
+    }
+
+    // metrics cached across edits match those of a new route with the same stops
+    TEST(RouteTest, CachedMetrics) {
+        Route r(backAndForth);
+        const Location locs[3] = {first, second, third};
+        for(int i = 0; i < 200; i++) {
+            size_t stop = rand() % r.size();
+            switch(rand() % 6) {
+                case 0: r.addStop(locs[rand() % 3], stop, rand() % 2 ? RLCopper : RLCopperConsume); break;
+                case 1: r.dropStop(r[stop]); break;
+                case 2: r.setResourceList(stop, rand() % 2 ? RLCopper : ResourceList()); break;
+                case 3: r.setResource(stop, Resource::Iron, rand() % 5 - 2); break;
+                case 4: r.reverse(); break;
+                case 5: r.rotate(stop); break;
+            }
+            PairList<FactoryKey, ResourceList> stops(r.cbegin(), r.cend());
+            Route fresh(stops);
+            EXPECT_EQ(r.getLength(), fresh.getLength());
+            EXPECT_EQ(r.getCarryover(), fresh.getCarryover());
+            EXPECT_EQ(r.getCarryTime(), fresh.getCarryTime());
+            EXPECT_EQ(r.getPeakCapacity(), fresh.getPeakCapacity());
+        }
+    }
+
 } // namespace RouteTest
\ No newline at end of file
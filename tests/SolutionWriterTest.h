@@ -0,0 +1,151 @@
+/*
+SolutionWriter unit test
+
+This file tests writing solved networks with the SolutionWriter,
+defined in SolutionWriter.h
+*/
+
+/////////////////
+// Includes
+/////////////////
+
+#include <gtest/gtest.h>
+#include "../headers/solutions/SolutionWriter.h"
+#include "../headers/solutions/solvers/GreedyEdgeList.h"
+#include "../headers/solutions/CanonicalExamples.h"
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+
+/////////////////
+// tests
+/////////////////
+
+namespace SolutionWriterTest {
+    std::string tempPath(const std::string& name) {
+        return testing::TempDir() + "SolutionWriterTest_" + name;
+    }
+
+    std::string readBytes(const std::string& path) {
+        std::ifstream in(path, std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+
+    Network solved(const Network& net) {
+        GreedyEdgeList solv(net, ALL_COSTS, Constraints());
+        return solv.solve();
+    }
+
+    TEST(SolutionWriterTest, JsonLines) {
+        Network net = solved(CANON_TWO_ZONES);
+        ASSERT_GT(net.getNumRoutes(), 0);
+        std::string path = tempPath("JsonLines.jsonl");
+        writeSolution(net, ALL_COSTS, path, SolutionWriter::JSON_LINES);
+
+        std::istringstream lines(readBytes(path));
+        std::string line;
+        ASSERT_TRUE(std::getline(lines, line));
+        EXPECT_EQ(line.find("{\"type\":\"cost\""), 0);
+        for(CostFunct::Metric m = CostFunct::Metric(0); m < CostFunct::Metric::COUNT; m++)
+            EXPECT_NE(line.find(std::string("\"") + metricName(m) + "\":{\"value\":"), std::string::npos);
+
+        // the cost reads back exactly
+        size_t at = line.find("\"cost\":") + 7;
+        EXPECT_EQ(std::stod(line.substr(at)), ALL_COSTS(net));
+
+        for(RouteKey r = 0; r < net.getNumRoutes(); r++) {
+            ASSERT_TRUE(std::getline(lines, line));
+            EXPECT_EQ(line.find("{\"type\":\"route\",\"route\":" + std::to_string(r) + ","), 0);
+            const Route& route = net.getRoute(r);
+            for(size_t i = 0; i < route.size(); i++) {
+                std::string stop = "{\"x\":" + std::to_string(route.stopKeys()[i].x) + ",\"y\":" + std::to_string(route.stopKeys()[i].y) + ",";
+                EXPECT_NE(line.find(stop), std::string::npos);
+            }
+            at = line.find("\"length\":") + 9;
+            EXPECT_EQ(std::stod(line.substr(at)), route.getLength().toDouble());
+        }
+        EXPECT_FALSE(std::getline(lines, line));
+    }
+
+    TEST(SolutionWriterTest, JsonCommand) {
+        Network net(CANON_BASIC);
+        ASSERT_TRUE(net.addRoute(net.factCBegin()->first, (++net.factCBegin())->first,
+            net.factCBegin()->second.getBaseQuants(), (++net.factCBegin())->second.getBaseQuants()));
+        std::string path = tempPath("JsonCommand.jsonl");
+        SolutionWriter writer(path, SolutionWriter::JSON_LINES);
+        writer.writeRoute(0, net.getRoute(0));
+        writer.close();
+        EXPECT_EQ(writer.getNumRoutes(), 1);
+
+        std::string text = readBytes(path);
+        const ResourceList& command = net.getRoute(0).stopCommands()[0];
+        for(Resource r = Resource(0); r != Resource::COUNT; r++) {
+            std::string field = std::string("\"") + resourceName(r) + "\":" + std::to_string(command[r]);
+            EXPECT_EQ(text.find(field) != std::string::npos, command[r] != 0);
+        }
+    }
+
+    // walks the records of a binary file and checks them against net
+    TEST(SolutionWriterTest, Binary) {
+        Network net = solved(CANON_DUAL_RES_PRODUCE);
+        std::string path = tempPath("Binary.fsol");
+        writeSolution(net, ALL_COSTS, path, SolutionWriter::BINARY);
+        std::string bytes = readBytes(path);
+        size_t at = 0;
+        auto take = [&](void* out, size_t size) {
+            ASSERT_LE(at + size, bytes.size());
+            std::memcpy(out, bytes.data() + at, size);
+            at += size;
+        };
+
+        SolutionFileHeader header;
+        take(&header, sizeof(header));
+        EXPECT_EQ(std::memcmp(header.magic, SolutionFile::MAGIC, sizeof(header.magic)), 0);
+        EXPECT_EQ(header.version, SolutionFile::VERSION);
+        EXPECT_EQ(header.num_resources, Resource::COUNT);
+
+        SolutionRecordHeader record;
+        take(&record, sizeof(record));
+        EXPECT_EQ(record.kind, SolutionFile::COST);
+        ASSERT_EQ(record.count, CostFunct::Metric::COUNT);
+        double total;
+        take(&total, sizeof(total));
+        EXPECT_EQ(total, ALL_COSTS(net));
+        std::array<double, CostFunct::Metric::COUNT> values = ALL_COSTS.getMetricValues(net);
+        for(size_t m = 0; m < CostFunct::Metric::COUNT; m++) {
+            SolutionMetricRecord metric;
+            take(&metric, sizeof(metric));
+            EXPECT_EQ(metric.value, values[m]);
+            EXPECT_EQ(metric.weight, ALL_COSTS.weights[m]);
+        }
+
+        for(RouteKey r = 0; r < net.getNumRoutes(); r++) {
+            const Route& route = net.getRoute(r);
+            take(&record, sizeof(record));
+            EXPECT_EQ(record.kind, SolutionFile::ROUTE);
+            ASSERT_EQ(record.count, route.size());
+            SolutionRouteRecord metrics;
+            take(&metrics, sizeof(metrics));
+            EXPECT_EQ(metrics.route, r);
+            EXPECT_EQ(((Dist){metrics.length_rat, metrics.length_irrat}), route.getLength());
+            EXPECT_EQ(metrics.carry_time, route.getCarryTime());
+            EXPECT_EQ(metrics.peak_capacity, route.getPeakCapacity());
+            for(size_t i = 0; i < route.size(); i++) {
+                Location stop;
+                take(&stop, sizeof(stop));
+                EXPECT_EQ(stop, route.stopKeys()[i]);
+            }
+            for(size_t i = 0; i < route.size(); i++) {
+                ResourceList command;
+                take(&command, sizeof(command));
+                EXPECT_EQ(command, route.stopCommands()[i]);
+            }
+        }
+        EXPECT_EQ(at, bytes.size());
+    }
+
+    TEST(SolutionWriterTest, BadPath) {
+        EXPECT_THROW(SolutionWriter("no/such/dir/solution.jsonl", SolutionWriter::JSON_LINES), std::runtime_error);
+    }
+}
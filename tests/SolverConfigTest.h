@@ -0,0 +1,78 @@
+/*
+SolverConfig unit test
+
+This file tests building solvers from a SolverConfig, defined in
+SolverConfig.h
+*/
+
+/////////////////
+// Includes
+/////////////////
+
+#include <gtest/gtest.h>
+#include "../headers/solutions/SolverConfig.h"
+#include "../headers/solutions/solvers/GreedyEdgeList.h"
+#include "../headers/solutions/solvers/Genetic.h"
+#include "../headers/solutions/CanonicalExamples.h"
+
+/////////////////
+// tests
+/////////////////
+
+namespace SolverConfigTest {
+    TEST(SolverConfigTest, Names) {
+        SolverConfig::Algorithm a;
+        EXPECT_TRUE(parseAlgorithm("genetic", a));
+        EXPECT_EQ(a, SolverConfig::GENETIC);
+        EXPECT_TRUE(parseAlgorithm(algorithmName(SolverConfig::GREEDY_EDGE_LIST), a));
+        EXPECT_EQ(a, SolverConfig::GREEDY_EDGE_LIST);
+        EXPECT_TRUE(parseAlgorithm("greedy-edge-list", a));
+        EXPECT_EQ(a, SolverConfig::GREEDY_EDGE_LIST);
+        EXPECT_FALSE(parseAlgorithm("annealing", a));
+        EXPECT_THROW(algorithmName(SolverConfig::Algorithm(7)), std::out_of_range);
+    }
+
+    TEST(SolverConfigTest, MakeSolver) {
+        SolverConfig config;
+        config.threads = 3;
+        config.seed = 42;
+        std::unique_ptr<Solver> greedy = config.makeSolver(CANON_DUAL_SERVE);
+        EXPECT_NE(dynamic_cast<GreedyEdgeList*>(greedy.get()), nullptr);
+        EXPECT_EQ(greedy->getThreads(), 3);
+        EXPECT_EQ(greedy->getSeed(), 42);
+
+        config.algorithm = SolverConfig::GENETIC;
+        config.num_iters = 5;
+        config.dist_w = 2.0;
+        std::unique_ptr<Solver> genetic = config.makeSolver(CANON_DUAL_SERVE);
+        EXPECT_NE(dynamic_cast<Genetic*>(genetic.get()), nullptr);
+        EXPECT_TRUE(config.constraints(genetic->solve()));
+    }
+
+    // a config solves the same way as the solver built by hand
+    TEST(SolverConfigTest, MatchesSolver) {
+        Network net = randomNetwork(3, 20, 100);
+        SolverConfig config;
+        config.quant_w = 2.0;
+        config.track = 3;
+        GreedyEdgeList solv(net, config.cost, config.constraints, config.dist_w, config.quant_w, config.track);
+        EXPECT_EQ(config.cost(config.makeSolver(net)->solve()), config.cost(solv.solve()));
+
+        // Genetic takes the weights in its constructor, like regenerating its edge list
+        config.algorithm = SolverConfig::GENETIC;
+        config.num_iters = 5;
+        Genetic gen(net, config.cost, config.constraints, config.num_iters);
+        gen.generateEdgeList(config.dist_w, config.quant_w);
+        EXPECT_EQ(config.cost(config.makeSolver(net)->solve()), config.cost(gen.solve()));
+    }
+
+    // the config's defaults are the solvers'
+    TEST(SolverConfigTest, Defaults) {
+        SolverConfig config;
+        EXPECT_EQ(config.algorithm, SolverConfig::GREEDY_EDGE_LIST);
+        EXPECT_EQ(config.dist_w, Solver::DEFAULT_DIST_W);
+        EXPECT_EQ(config.quant_w, Solver::DEFAULT_QUANT_W);
+        EXPECT_EQ(config.track, GreedyEdgeList::DEFAULT_TRACK);
+        EXPECT_EQ(config.num_iters, Genetic::DEFAULT_ITERS);
+    }
+}
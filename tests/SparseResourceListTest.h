@@ -0,0 +1,99 @@
+#include <gtest/gtest.h>
+#include "../headers/data/SparseResourceList.h"
+#include "TestSetup.h"
+
+namespace SparseResourceListTest {
+    TEST(SparseResourceListTest, Empty) {
+        SparseResourceList rl;
+        EXPECT_TRUE(rl.isEmpty());
+        EXPECT_EQ(rl.count(), 0);
+        EXPECT_EQ(rl.toDense(), ResourceList());
+        EXPECT_EQ(SparseResourceList(ResourceList()), rl);
+        EXPECT_THROW(rl[Resource::COUNT], std::out_of_range);
+    }
+
+    TEST(SparseResourceListTest, SetAndGet) {
+        SparseResourceList rl;
+        rl.set(Resource::Iron, 3);
+        rl.set(Resource::Copper, -2);
+        EXPECT_EQ(rl[Resource::Steel], 0);
+        rl.set(Resource::Steel, 7);
+        EXPECT_EQ(rl.count(), 3);
+        EXPECT_EQ(rl[Resource::Copper], -2);
+        EXPECT_EQ(rl[Resource::Iron], 3);
+        EXPECT_EQ(rl[Resource::Steel], 7);
+        EXPECT_EQ(rl.negativeMask(), 1u << Resource::Copper);
+        EXPECT_EQ(rl.positiveMask(), (1u << Resource::Iron) | (1u << Resource::Steel));
+        EXPECT_EQ(rl.total(), 8);
+        // setting 0 removes a resource
+        rl.set(Resource::Iron, 0);
+        EXPECT_EQ(rl.count(), 2);
+        EXPECT_EQ(rl[Resource::Iron], 0);
+        EXPECT_EQ(rl[Resource::Steel], 7);
+    }
+
+    // random lists of every density, past the inline capacity
+    TEST(SparseResourceListTest, MatchesDense) {
+        for(int iter = 0; iter < 200; iter++) {
+            ResourceList dense;
+            SparseResourceList sparse;
+            int active = rand() % Resource::COUNT;
+            for(int i = 0; i < active * 2; i++) {
+                size_t r = rand() % Resource::COUNT;
+                Quant q = rand() % 3 ? rand() % 21 - 10 : 0;
+                dense[r] = q;
+                sparse.set(r, q);
+            }
+            EXPECT_EQ(sparse.toDense(), dense);
+            EXPECT_EQ(SparseResourceList(dense), sparse);
+            EXPECT_EQ(sparse.negativeMask(), dense.negativeMask());
+            EXPECT_EQ(sparse.positiveMask(), dense.positiveMask());
+            EXPECT_EQ(sparse.total(), dense.total());
+            // copies are independent
+            SparseResourceList copy = sparse;
+            copy.set(0, 99);
+            EXPECT_EQ(sparse.toDense(), dense);
+            // arithmetic against dense lists
+            ResourceList base;
+            for(size_t r = 0; r < Resource::COUNT; r++)
+                base[r] = rand() % 21 - 10;
+            ResourceList sum = base, diff = base;
+            sparse.addTo(sum);
+            sparse.subtractFrom(diff);
+            EXPECT_EQ(sum, base + dense);
+            EXPECT_EQ(diff, base - dense);
+            EXPECT_EQ(sparse.negated().toDense(), ResourceList() - dense);
+        }
+    }
+
+    // moved from lists are empty and usable, whether the Quants were inline or
+    // spilled, as far as the catalogue lets them spill
+    TEST(SparseResourceListTest, Move) {
+        for(size_t n : {size_t(2), std::min(SparseResourceList::INLINE_CAPACITY + 2, size_t(Resource::COUNT))}) {
+            ResourceList dense;
+            for(size_t r = 0; r < n; r++)
+                dense[r] = Quant(r) + 1;
+            SparseResourceList from(dense);
+
+            SparseResourceList to(std::move(from));
+            EXPECT_EQ(to.toDense(), dense);
+            EXPECT_TRUE(from.isEmpty());
+            EXPECT_EQ(from.count(), 0);
+            EXPECT_EQ(from.total(), 0);
+            EXPECT_EQ(from[n - 1], 0);
+            EXPECT_EQ(from, SparseResourceList());
+
+            SparseResourceList assigned;
+            assigned.set(Resource::Steel, 5);
+            assigned = std::move(to);
+            EXPECT_EQ(assigned.toDense(), dense);
+            EXPECT_TRUE(to.isEmpty());
+            EXPECT_EQ(to.toDense(), ResourceList());
+
+            // reusing a moved from list
+            from.set(Resource::Iron, 4);
+            EXPECT_EQ(from[Resource::Iron], 4);
+            EXPECT_EQ(from.count(), 1);
+        }
+    }
+}
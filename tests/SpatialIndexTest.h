@@ -0,0 +1,75 @@
+#include <gtest/gtest.h>
+#include "../headers/data/SpatialIndex.h"
+#include "TestSetup.h"
+#include <algorithm>
+
+namespace SpatialIndexTest {
+    std::vector<Location> randomLocs(size_t n, Coord spread) {
+        std::vector<Location> locs;
+        for(size_t i = 0; i < n; i++)
+            locs.push_back(Location(rand() % (2*spread+1) - spread, rand() % (2*spread+1) - spread));
+        return locs;
+    }
+
+    // brute force k nearest, ordered like SpatialIndex::kNearest
+    std::vector<size_t> slowNearest(const std::vector<Location>& locs, Location center, size_t k) {
+        std::vector<std::pair<Dist, size_t>> all;
+        for(size_t i = 0; i < locs.size(); i++)
+            all.emplace_back(dist(center, locs[i]), i);
+        std::sort(all.begin(), all.end());
+        std::vector<size_t> out;
+        for(size_t i = 0; i < std::min(k, all.size()); i++)
+            out.push_back(all[i].second);
+        return out;
+    }
+
+    TEST(SpatialIndexTest, Empty) {
+        SpatialIndex index;
+        EXPECT_EQ(index.size(), 0);
+        EXPECT_TRUE(index.kNearest(Location(0, 0), 3).empty());
+        EXPECT_TRUE(index.withinRadius(Location(0, 0), (Dist){10, 0}).empty());
+    }
+
+    TEST(SpatialIndexTest, Small) {
+        std::vector<Location> locs = {
+            Location(0, 0), Location(3, 0), Location(2, 2), Location(-5, 1), Location(3, 0)
+        };
+        SpatialIndex index(locs);
+        // (2,2) is 2 diagonals away, (3,0) is 3 straight away
+        EXPECT_EQ(index.kNearest(Location(0, 0), 3), (std::vector<size_t>{0, 2, 1}));
+        EXPECT_EQ(index.kNearest(Location(0, 0), 4), (std::vector<size_t>{0, 2, 1, 4}));
+        EXPECT_EQ(index.kNearest(Location(0, 0), 10).size(), locs.size());
+        EXPECT_EQ(index.withinRadius(Location(0, 0), (Dist){3, 0}), (std::vector<size_t>{0, 1, 2, 4}));
+        EXPECT_EQ(index.withinRadius(Location(-5, 1), (Dist){0, 0}), (std::vector<size_t>{3}));
+    }
+
+    TEST(SpatialIndexTest, KNearest_Random) {
+        for(int iter = 0; iter < 20; iter++) {
+            std::vector<Location> locs = randomLocs(rand() % 300 + 1, rand() % MAX_LOC_COORD + 1);
+            SpatialIndex index(locs);
+            for(int q = 0; q < 20; q++) {
+                // queries inside and outside the grid
+                Location center(rand() % (4*MAX_LOC_COORD) - 2*MAX_LOC_COORD, rand() % (4*MAX_LOC_COORD) - 2*MAX_LOC_COORD);
+                size_t k = rand() % 10 + 1;
+                EXPECT_EQ(index.kNearest(center, k), slowNearest(locs, center, k));
+            }
+        }
+    }
+
+    TEST(SpatialIndexTest, WithinRadius_Random) {
+        for(int iter = 0; iter < 20; iter++) {
+            std::vector<Location> locs = randomLocs(rand() % 300 + 1, rand() % MAX_LOC_COORD + 1);
+            // small cells, so queries span many of them
+            SpatialIndex index(locs, rand() % 20 + 1);
+            for(int q = 0; q < 20; q++) {
+                Location center = locs[rand() % locs.size()];
+                Dist radius = {rand() % 200, rand() % 200};
+                std::vector<size_t> expected;
+                for(size_t i = 0; i < locs.size(); i++)
+                    if(dist(center, locs[i]) <= radius)
+                        expected.push_back(i);
+                EXPECT_EQ(index.withinRadius(center, radius), expected);
+            }
+        }
+    }
+}
@@ -13,4 +13,9 @@ void setupTests() {
     srand(time(0));
 }
 
+// skips a test written against the first n resources when the build's
+// catalogue is smaller, see RESOURCE_COUNT
+#define REQUIRE_RESOURCES(n) \
+    if(Resource::COUNT < (n)) GTEST_SKIP() << "needs " << (n) << " resources"
+
 #endif
\ No newline at end of file
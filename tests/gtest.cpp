@@ -4,12 +4,21 @@
 // #include "ResourceTest.h"
 // #include "LocationTest.h"
 // #include "DistTest.h"
+// #include "SparseResourceListTest.h"
+// #include "SpatialIndexTest.h"
+// #include "DistanceCacheTest.h"
+// #include "HashCounterTest.h"
 // #include "FactoryTest.h"
 // #include "RouteTest.h"
 // #include "NetworkTest.h"
+// #include "NetworkFileTest.h"
 
 // #include "ConstraintsTest.h"
 // #include "CostFunctTest.h"
+// #include "FactoryImportTest.h"
+// #include "SolutionWriterTest.h"
+// #include "SolverConfigTest.h"
+// #include "BatchSolverTest.h"
 
 #include "JunctionFunctionTest.h"
 // #include "CanonicalExamplesTest.h"
@@ -17,6 +26,9 @@
 // #include "GeneticTest.h"
 
 #include "SolverAnalysis.h"
+// #include "ResourceListAnalysis.h"
+// #include "DistAnalysis.h"
+// #include "ImportAnalysis.h"
 
 int main(int argc, char **argv) {
     setupTests();